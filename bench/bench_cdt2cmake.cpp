@@ -0,0 +1,248 @@
+/*
+ * bench_cdt2cmake.cpp
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#include <string>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#include "cdtproject.h"
+#include "project.h"
+#include "workspacegen.h"
+
+/*
+ * Generates a synthetic workspace and times the conversion phases over
+ * all its projects. Output is tab separated, one row per phase, so runs
+ * can be compared with diff or a spreadsheet.
+ */
+
+namespace
+{
+
+typedef std::chrono::steady_clock clock_type;
+
+enum phase
+{
+	parse,
+	discovery,
+	merge,
+	emit,
+	total,
+	phase_count
+};
+
+const char* phase_names[] = {"parse", "discovery", "merge", "emit", "total"};
+
+struct counts_t
+{
+	std::size_t configurations = 0;
+	std::size_t folders = 0;
+	std::size_t sources = 0;
+	std::size_t listfile_bytes = 0;
+};
+
+double elapsed_ms(clock_type::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+}
+
+// Converts every project once; times[p] receives the time spent in phase p.
+void run(const std::vector<std::string>& projects, double* times, counts_t& counts)
+{
+	std::fill(times, times + phase_count, 0.0);
+	counts = counts_t();
+
+	cmake::options opts;
+	for(auto& project_base : projects)
+	{
+		auto start = clock_type::now();
+		cdt::project cdtproject(project_base);
+		times[parse] += elapsed_ms(start);
+
+		cmake::project_model model;
+		cmake::result res;
+		start = clock_type::now();
+		cmake::discover(cdtproject, opts, model, res);
+		times[discovery] += elapsed_ms(start);
+
+		start = clock_type::now();
+		cmake::merge(cdtproject, model);
+		times[merge] += elapsed_ms(start);
+
+		start = clock_type::now();
+		auto listfile = cmake::emit(model);
+		times[emit] += elapsed_ms(start);
+
+		counts.configurations += cdtproject.cconfigurations().size();
+		for(auto& artifact : model.artifacts)
+			counts.folders += artifact.second.build_folders.size();
+		for(auto& folder : model.sources)
+			counts.sources += folder.second.size();
+		counts.listfile_bytes += listfile.size();
+	}
+
+	for(int p = parse; p < total; ++p)
+		times[total] += times[p];
+}
+
+void usage(const std::string& program_name)
+{
+	std::cout << program_name << " [options]\n";
+	std::cout << "   --projects N        projects in the workspace (16)\n";
+	std::cout << "   --configurations N  cconfigurations per project (2)\n";
+	std::cout << "   --folders N         folderInfo entries per configuration (4)\n";
+	std::cout << "   --files N           fileInfo entries per configuration (4)\n";
+	std::cout << "   --option-values N   listOptionValue entries per list option (8)\n";
+	std::cout << "   --depth N           source tree depth (3)\n";
+	std::cout << "   --width N           subfolders per source folder (3)\n";
+	std::cout << "   --sources N         source files per folder (8)\n";
+	std::cout << "   --iterations N      timed runs (5)\n";
+	std::cout << "   --dir PATH          write the workspace to PATH and keep it\n";
+	std::cout << "   --generate-only     write the workspace and exit\n";
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+	std::vector<std::string> args{argv + 1, argv + argc};
+	std::string program_name = argv[0];
+
+	workspace_spec spec;
+	unsigned int iterations = 5;
+	std::string dir;
+	bool generate_only = false;
+
+	struct
+	{
+		const char* name;
+		unsigned int* value;
+	} numeric_options[] = {
+		{"--projects", &spec.projects},
+		{"--configurations", &spec.configurations},
+		{"--folders", &spec.folders},
+		{"--files", &spec.files},
+		{"--option-values", &spec.option_values},
+		{"--depth", &spec.depth},
+		{"--width", &spec.width},
+		{"--sources", &spec.sources},
+		{"--iterations", &iterations}
+	};
+
+	for(auto it = begin(args); it != end(args); ++it)
+	{
+		auto& arg = *it;
+		if(arg == "--help")
+		{
+			usage(program_name);
+			return 0;
+		}
+		if(arg == "--generate-only")
+		{
+			generate_only = true;
+			continue;
+		}
+
+		bool known = false;
+		for(auto& option : numeric_options)
+		{
+			if(arg != option.name)
+				continue;
+			known = true;
+			if(++it == end(args))
+			{
+				std::cerr << "Missing value for " << arg << "\n";
+				return 1;
+			}
+			*option.value = std::strtoul(it->c_str(), nullptr, 10);
+		}
+		if(known)
+			continue;
+
+		if(arg == "--dir" && it + 1 != end(args))
+		{
+			dir = *++it;
+			continue;
+		}
+
+		std::cerr << "Unknown argument: " << arg << "\n";
+		usage(program_name);
+		return 1;
+	}
+
+	if(generate_only && dir.empty())
+	{
+		std::cerr << "--generate-only requires --dir\n";
+		return 1;
+	}
+	if(spec.projects == 0 || iterations == 0)
+	{
+		std::cerr << "Nothing to measure\n";
+		return 1;
+	}
+
+	bool keep = !dir.empty();
+	if(dir.empty())
+	{
+		char temp[] = "/tmp/bench_cdt2cmake.XXXXXX";
+		if(!mkdtemp(temp))
+		{
+			std::cerr << "Unable to create workspace directory\n";
+			return 1;
+		}
+		dir = temp;
+	}
+
+	int status = 0;
+	try
+	{
+		auto projects = generate_workspace(dir, spec);
+		if(generate_only)
+			return 0;
+
+		// warm the page cache and allocator before measuring
+		double times[phase_count];
+		counts_t counts;
+		run(projects, times, counts);
+
+		std::vector<double> samples[phase_count];
+		for(unsigned int i = 0; i < iterations; ++i)
+		{
+			run(projects, times, counts);
+			for(int p = 0; p < phase_count; ++p)
+				samples[p].push_back(times[p]);
+		}
+
+		std::cout << "# projects=" << spec.projects << " configurations=" << spec.configurations
+				<< " folders=" << spec.folders << " files=" << spec.files << " option_values=" << spec.option_values
+				<< " depth=" << spec.depth << " width=" << spec.width << " sources=" << spec.sources
+				<< " iterations=" << iterations << "\n";
+		std::cout << "# parsed_configurations=" << counts.configurations << " merged_folders=" << counts.folders
+				<< " sources=" << counts.sources << " listfile_bytes=" << counts.listfile_bytes << "\n";
+		std::cout << "phase\tmin_ms\tmedian_ms\tmax_ms\n";
+		std::cout.setf(std::ios::fixed);
+		std::cout.precision(3);
+		for(int p = 0; p < phase_count; ++p)
+		{
+			auto& s = samples[p];
+			std::sort(s.begin(), s.end());
+			std::cout << phase_names[p] << '\t' << s.front() << '\t' << s[s.size() / 2] << '\t' << s.back() << '\n';
+		}
+	}
+	catch(const std::exception& ex)
+	{
+		std::cerr << "Error: " << ex.what() << "\n";
+		status = 1;
+	}
+
+	if(!keep)
+		remove_tree(dir);
+	return status;
+}
@@ -0,0 +1,263 @@
+/*
+ * workspacegen.cpp
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#include "workspacegen.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#include <sys/stat.h>
+#include <ftw.h>
+
+namespace
+{
+
+void throw_if(bool condition, const std::string& what)
+{
+	if(condition)
+		throw std::runtime_error(what);
+}
+
+void make_directory(const std::string& path)
+{
+	throw_if(mkdir(path.c_str(), 0777) != 0 && errno != EEXIST, "Unable to create " + path + ": " + std::strerror(errno));
+}
+
+void write(const std::string& filename, const std::string& content)
+{
+	std::ofstream os(filename);
+	os << content;
+	throw_if(!os, "Unable to write " + filename);
+}
+
+struct artifact_kind
+{
+	const char* tag;
+	const char* type;
+};
+
+const artifact_kind artifact_kinds[] = {
+	{"exe", "org.eclipse.cdt.build.core.buildArtefactType.exe"},
+	{"lib", "org.eclipse.cdt.build.core.buildArtefactType.staticLib"},
+	{"so", "org.eclipse.cdt.build.core.buildArtefactType.sharedLib"}
+};
+
+std::string project_name(unsigned int index)
+{
+	return "project" + std::to_string(index);
+}
+
+/*
+ * Writes a source tree of the given depth and width and returns its
+ * directories (relative, "" for the root) and source files.
+ */
+void write_sources(const std::string& base, const std::string& rel, unsigned int depth, const workspace_spec& spec,
+		std::vector<std::string>& dirs, std::vector<std::string>& files)
+{
+	dirs.push_back(rel);
+	auto prefix = rel.empty() ? rel : rel + "/";
+
+	for(unsigned int i = 0; i < spec.sources; ++i)
+	{
+		auto stem = "src" + std::to_string(i);
+		std::string ext = (i % 4 == 3) ? ".c" : ".cpp";
+		write(base + prefix + stem + ext, "int " + stem + "() { return " + std::to_string(i) + "; }\n");
+		files.push_back(prefix + stem + ext);
+	}
+	write(base + prefix + "header.h", "#pragma once\n");
+
+	if(depth == 0)
+		return;
+
+	for(unsigned int i = 0; i < spec.width; ++i)
+	{
+		auto dir = prefix + "dir" + std::to_string(i);
+		make_directory(base + dir);
+		write_sources(base, dir, depth - 1, spec, dirs, files);
+	}
+}
+
+void write_project_file(const std::string& base, const std::string& name)
+{
+	std::ostringstream os;
+	os << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+	os << "<projectDescription>\n";
+	os << "\t<name>" << name << "</name>\n";
+	os << "\t<comment>synthetic benchmark project</comment>\n";
+	os << "\t<projects>\n\t</projects>\n";
+	os << "\t<buildSpec>\n";
+	os << "\t\t<buildCommand>\n";
+	os << "\t\t\t<name>org.eclipse.cdt.managedbuilder.core.genmakebuilder</name>\n";
+	os << "\t\t\t<triggers>clean,full,incremental,</triggers>\n";
+	os << "\t\t\t<arguments>\n\t\t\t</arguments>\n";
+	os << "\t\t</buildCommand>\n";
+	os << "\t</buildSpec>\n";
+	os << "\t<natures>\n";
+	os << "\t\t<nature>org.eclipse.cdt.core.cnature</nature>\n";
+	os << "\t\t<nature>org.eclipse.cdt.core.ccnature</nature>\n";
+	os << "\t\t<nature>org.eclipse.cdt.managedbuilder.core.managedBuildNature</nature>\n";
+	os << "\t</natures>\n";
+	os << "</projectDescription>\n";
+	write(base + ".project", os.str());
+}
+
+void write_list_option(std::ostream& os, const std::string& superClass, const std::vector<std::string>& values)
+{
+	os << "\t\t\t\t\t\t\t\t<option id=\"" << superClass << ".1\" superClass=\"" << superClass << "\" valueType=\"stringList\">\n";
+	for(auto& value : values)
+		os << "\t\t\t\t\t\t\t\t\t<listOptionValue builtIn=\"false\" value=\"" << value << "\"/>\n";
+	os << "\t\t\t\t\t\t\t\t</option>\n";
+}
+
+void write_tools(std::ostream& os, const std::string& id, unsigned int project, unsigned int conf, const workspace_spec& spec)
+{
+	std::vector<std::string> includes;
+	std::vector<std::string> libs;
+	std::vector<std::string> lib_paths;
+	for(unsigned int i = 0; i < spec.option_values; ++i)
+	{
+		auto other = project_name((project + i + 1) % spec.projects);
+		switch(i % 3)
+		{
+			case 0:
+				includes.push_back("&quot;${workspace_loc:/" + other + "/include}&quot;");
+				break;
+			case 1:
+				includes.push_back("../../" + other + "/src");
+				break;
+			case 2:
+				includes.push_back("/usr/include/lib" + std::to_string(i));
+				break;
+		}
+		libs.push_back("lib" + std::to_string(i));
+		lib_paths.push_back(i % 2 ? "/usr/lib/lib" + std::to_string(i) : "&quot;${workspace_loc:/" + other + "/Debug}&quot;");
+	}
+
+	auto flags = "-c -fmessage-length=0 -Wall -DCONFIG" + std::to_string(conf);
+	const char* compilers[] = {"cpp", "c"};
+	for(auto lang : compilers)
+	{
+		std::string tool = std::string("cdt.managedbuild.tool.gnu.") + lang + ".compiler.exe.debug";
+		os << "\t\t\t\t\t\t\t<tool id=\"" << tool << "." << id << "\" name=\"GCC Compiler\" superClass=\"" << tool << "\">\n";
+		os << "\t\t\t\t\t\t\t\t<option id=\"gnu." << lang << ".compiler.option.optimization.level." << id << "\" superClass=\"gnu." << lang << ".compiler.exe.debug.option.optimization.level\" value=\"gnu." << lang << ".compiler.optimization.level.none\" valueType=\"enumerated\"/>\n";
+		write_list_option(os, std::string("gnu.") + lang + ".compiler.option.include.paths", includes);
+		os << "\t\t\t\t\t\t\t\t<option id=\"gnu." << lang << ".compiler.option.other.other." << id << "\" superClass=\"gnu." << lang << ".compiler.option.other.other\" value=\"" << flags << "\" valueType=\"string\"/>\n";
+		os << "\t\t\t\t\t\t\t\t<inputType id=\"cdt.managedbuild.tool.gnu." << lang << ".compiler.input." << id << "\" superClass=\"cdt.managedbuild.tool.gnu." << lang << ".compiler.input\"/>\n";
+		os << "\t\t\t\t\t\t\t</tool>\n";
+	}
+
+	const char* linkers[] = {"cpp", "c"};
+	for(auto lang : linkers)
+	{
+		std::string tool = std::string("cdt.managedbuild.tool.gnu.") + lang + ".linker.exe.debug";
+		os << "\t\t\t\t\t\t\t<tool id=\"" << tool << "." << id << "\" name=\"GCC Linker\" superClass=\"" << tool << "\">\n";
+		write_list_option(os, std::string("gnu.") + lang + ".link.option.libs", libs);
+		write_list_option(os, std::string("gnu.") + lang + ".link.option.paths", lib_paths);
+		os << "\t\t\t\t\t\t\t\t<option id=\"gnu." << lang << ".link.option.flags." << id << "\" superClass=\"gnu." << lang << ".link.option.flags\" value=\"-Wl,--as-needed\" valueType=\"string\"/>\n";
+		os << "\t\t\t\t\t\t\t</tool>\n";
+	}
+}
+
+void write_cproject_file(const std::string& base, unsigned int project, const workspace_spec& spec,
+		const std::vector<std::string>& dirs, const std::vector<std::string>& files)
+{
+	auto& kind = artifact_kinds[project % 3];
+
+	std::ostringstream os;
+	os << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n";
+	os << "<?fileVersion 4.0.0?><cproject storage_type_id=\"org.eclipse.cdt.core.XmlProjectDescriptionStorage\">\n";
+	os << "\t<storageModule moduleId=\"org.eclipse.cdt.core.settings\">\n";
+	for(unsigned int conf = 0; conf < spec.configurations; ++conf)
+	{
+		auto name = "Config" + std::to_string(conf);
+		auto id = std::string("cdt.managedbuild.config.gnu.") + kind.tag + "." + std::to_string(project) + "." + std::to_string(conf);
+
+		os << "\t\t<cconfiguration id=\"" << id << "\">\n";
+		os << "\t\t\t<storageModule buildSystemId=\"org.eclipse.cdt.managedbuilder.core.configurationDataProvider\" id=\"" << id << "\" moduleId=\"org.eclipse.cdt.core.settings\" name=\"" << name << "\">\n";
+		os << "\t\t\t\t<externalSettings/>\n";
+		os << "\t\t\t\t<extensions>\n";
+		os << "\t\t\t\t\t<extension id=\"org.eclipse.cdt.core.ELF\" point=\"org.eclipse.cdt.core.BinaryParser\"/>\n";
+		os << "\t\t\t\t\t<extension id=\"org.eclipse.cdt.core.GCCErrorParser\" point=\"org.eclipse.cdt.core.ErrorParser\"/>\n";
+		os << "\t\t\t\t</extensions>\n";
+		os << "\t\t\t</storageModule>\n";
+		os << "\t\t\t<storageModule moduleId=\"cdtBuildSystem\" version=\"4.0.0\">\n";
+		os << "\t\t\t\t<configuration artifactName=\"${ProjName}\" buildArtefactType=\"" << kind.type << "\" cleanCommand=\"rm -rf\" description=\"\" id=\"" << id << "\" name=\"" << name << "\" parent=\"cdt.managedbuild.config.gnu.exe.debug\" postbuildStep=\"echo post" << conf << "\" prebuildStep=\"\">\n";
+
+		for(unsigned int folder = 0; folder <= spec.folders && folder < dirs.size(); ++folder)
+		{
+			auto& path = dirs[folder];
+			auto folder_id = id + "." + std::to_string(folder);
+			os << "\t\t\t\t\t<folderInfo id=\"" << folder_id << "\" name=\"/" << path << "\" resourcePath=\"" << path << "\">\n";
+			os << "\t\t\t\t\t\t<toolChain id=\"cdt.managedbuild.toolchain.gnu.exe.debug." << folder_id << "\" name=\"Linux GCC\" superClass=\"cdt.managedbuild.toolchain.gnu.exe.debug\">\n";
+			os << "\t\t\t\t\t\t\t<targetPlatform id=\"cdt.managedbuild.target.gnu.platform.exe.debug." << folder_id << "\" name=\"Debug Platform\" superClass=\"cdt.managedbuild.target.gnu.platform.exe.debug\"/>\n";
+			write_tools(os, folder_id, project, conf, spec);
+			os << "\t\t\t\t\t\t</toolChain>\n";
+			os << "\t\t\t\t\t</folderInfo>\n";
+		}
+
+		for(unsigned int file = 0; file < spec.files && file < files.size(); ++file)
+		{
+			auto& path = files[file];
+			auto file_id = id + ".file" + std::to_string(file);
+			os << "\t\t\t\t\t<fileInfo id=\"" << file_id << "\" name=\"" << path.substr(path.rfind('/') + 1) << "\" rcbsApplicability=\"disable\" resourcePath=\"" << path << "\" toolsToInvoke=\"" << file_id << ".tool\">\n";
+			os << "\t\t\t\t\t\t<tool announcement=\"Generating\" command=\"generate" << file << " &gt; $@\" customBuildStep=\"true\" id=\"" << file_id << ".tool\" name=\"Custom Build Step\">\n";
+			os << "\t\t\t\t\t\t\t<inputType id=\"" << file_id << ".input\"><additionalInput kind=\"additionalinputdependency\" paths=\"" << path << ".in\"/></inputType>\n";
+			os << "\t\t\t\t\t\t\t<outputType id=\"" << file_id << ".output\" outputNames=\"" << path << "\"/>\n";
+			os << "\t\t\t\t\t\t</tool>\n";
+			os << "\t\t\t\t\t</fileInfo>\n";
+		}
+
+		os << "\t\t\t\t</configuration>\n";
+		os << "\t\t\t</storageModule>\n";
+		os << "\t\t\t<storageModule moduleId=\"org.eclipse.cdt.core.externalSettings\"/>\n";
+		os << "\t\t</cconfiguration>\n";
+	}
+	os << "\t</storageModule>\n";
+	os << "\t<storageModule moduleId=\"cdtBuildSystem\" version=\"4.0.0\">\n";
+	os << "\t\t<project id=\"" << project_name(project) << ".cdt.managedbuild.target.gnu." << kind.tag << "\" name=\"Benchmark\" projectType=\"cdt.managedbuild.target.gnu." << kind.tag << "\"/>\n";
+	os << "\t</storageModule>\n";
+	os << "\t<storageModule moduleId=\"scannerConfiguration\">\n";
+	os << "\t\t<autodiscovery enabled=\"true\" problemReportingEnabled=\"true\" selectedProfileId=\"\"/>\n";
+	os << "\t</storageModule>\n";
+	os << "</cproject>\n";
+	write(base + ".cproject", os.str());
+}
+
+int remove_entry(const char* path, const struct stat*, int, struct FTW*)
+{
+	return remove(path);
+}
+
+}
+
+std::vector<std::string> generate_workspace(const std::string& root, const workspace_spec& spec)
+{
+	std::vector<std::string> projects;
+	auto prefix = root.empty() || root.back() == '/' ? root : root + "/";
+
+	for(unsigned int project = 0; project < spec.projects; ++project)
+	{
+		auto name = project_name(project);
+		auto base = prefix + name + "/";
+		make_directory(base);
+
+		std::vector<std::string> dirs;
+		std::vector<std::string> files;
+		write_sources(base, "", spec.depth, spec, dirs, files);
+
+		write_project_file(base, name);
+		write_cproject_file(base, project, spec, dirs, files);
+		projects.push_back(base);
+	}
+	return projects;
+}
+
+void remove_tree(const std::string& path)
+{
+	nftw(path.c_str(), remove_entry, 64, FTW_DEPTH | FTW_PHYS);
+}
@@ -0,0 +1,47 @@
+/*
+ * workspacegen.h
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#ifndef WORKSPACEGEN_H_
+#define WORKSPACEGEN_H_
+#include <string>
+#include <vector>
+
+/*
+ * Shape of a synthetic Eclipse workspace. Every project gets the same
+ * shape; artifact types cycle through executable, static and shared
+ * library so all the emit paths are exercised.
+ */
+struct workspace_spec
+{
+	unsigned int projects = 16;
+
+	// cconfigurations per project
+	unsigned int configurations = 2;
+
+	// folderInfo entries per configuration besides the project root
+	unsigned int folders = 4;
+
+	// fileInfo entries (custom build steps) per configuration
+	unsigned int files = 4;
+
+	// listOptionValue entries per include path, library and library path option
+	unsigned int option_values = 8;
+
+	// source tree below each project root
+	unsigned int depth = 3;
+	unsigned int width = 3;
+	unsigned int sources = 8;
+};
+
+// Writes the workspace below root (which must exist) and returns the
+// project folders, each with a trailing '/'.
+std::vector<std::string> generate_workspace(const std::string& root, const workspace_spec& spec);
+
+// Removes a tree written by generate_workspace.
+void remove_tree(const std::string& path);
+
+#endif /* WORKSPACEGEN_H_ */
@@ -10,12 +10,475 @@
 #include <vector>
 #include <algorithm>
 #include <cassert>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
 
 #include "cdtproject.h"
 #include "project.h"
+#include "workerpool.h"
+#include "conversioncache.h"
+#include "timings.h"
+#include "workspace.h"
+#include "fileio.h"
+#include "watch.h"
+#include "compiledb.h"
 
 void usage(const std::string& program_name);
 
+struct conversion_settings
+{
+	cmake::options opts;
+
+	// Keep a manifest in each project folder...
+	bool project_cache = false;
+	// ...or one manifest for all projects.
+	conversion_cache* workspace_cache = nullptr;
+
+	// Projects converting or waiting to print their output at once; 0 for
+	// no limit.
+	std::size_t max_resident = 0;
+
+	// With dependency_order, share settings blocks used by this many
+	// projects; 0 to not share.
+	std::size_t shared_settings = 0;
+
+	// Keep the model of each project converted here, indexed like the
+	// projects, instead of freeing it once the listfile is rendered.
+	std::vector<cmake::project_model>* models = nullptr;
+};
+
+enum class outcome
+{
+	converted,
+	unchanged,	// converted, but the listfile already had that content
+	up_to_date,
+	failed
+};
+
+const char* to_string(outcome o)
+{
+	switch(o)
+	{
+		case outcome::converted:
+			return "converted";
+		case outcome::unchanged:
+			return "unchanged";
+		case outcome::up_to_date:
+			return "up to date";
+		case outcome::failed:
+			return "failed";
+	}
+	return "unknown";
+}
+
+// Parses the project and builds its model; the parsed project is gone
+// before the listfile is rendered.
+cmake::project_model extract_project(const std::string& project_base, const conversion_settings& settings, cmake::result& res, project_timings* timings)
+{
+	std::unique_ptr<cdt::project> cdtproject;
+	{
+		phase_timer timer(timings, phase::parse);
+		cdtproject.reset(new cdt::project(project_base));
+	}
+	if(timings)
+		timings->xml_bytes = cdtproject->descriptor_size();
+
+	return cmake::extract(*cdtproject, settings.opts, res, timings);
+}
+
+outcome convert(const std::string& project_base, const conversion_settings& settings, std::ostream& out, std::ostream& err, project_timings* timings,
+		cmake::project_model* kept)
+{
+	try
+	{
+		std::unique_ptr<conversion_cache> project_cache;
+		auto cache = settings.workspace_cache;
+		auto options_digest = cmake::digest(settings.opts);
+		conversion_cache::snapshot_t before{};
+		if(settings.project_cache || cache)
+		{
+			phase_timer timer(timings, phase::cache);
+			if(settings.project_cache)
+			{
+				project_cache.reset(new conversion_cache(project_base + ".cdt2cmake.cache"));
+				project_cache->load();
+				cache = project_cache.get();
+			}
+
+			if(cache->up_to_date(project_base, options_digest))
+			{
+				if(project_cache)
+					project_cache->save();
+				return outcome::up_to_date;
+			}
+			before = cache->snapshot(project_base);
+		}
+
+		cmake::result res;
+		auto model = extract_project(project_base, settings, res, timings);
+		cmake::render(model, settings.opts, out, res, timings);
+		if(kept)
+			*kept = std::move(model);
+
+		if(cache)
+		{
+			phase_timer timer(timings, phase::cache);
+			cache->update(project_base, before, options_digest, res);
+			if(project_cache && !project_cache->save())
+				err << "Warning: unable to write " << project_base << ".cdt2cmake.cache\n";
+		}
+		if(res.listfile_unchanged)
+			return outcome::unchanged;
+	}
+	catch(const std::exception& ex)
+	{
+		err << "Error: " << ex.what() << "\n";
+		return outcome::failed;
+	}
+	return outcome::converted;
+}
+
+/*
+ * Converts the selected projects on a worker pool. Output of each
+ * project is buffered and written in selection order as soon as all
+ * the projects before it have completed. With max_resident, a project
+ * is only started once the output of all but max_resident - 1 projects
+ * before it has been written, which bounds the memory held.
+ */
+void convert_parallel(const std::vector<std::string>& projects, const std::vector<std::size_t>& selection, const conversion_settings& settings,
+		unsigned int jobs, std::vector<outcome>& outcomes, std::vector<project_timings>* timings)
+{
+	struct result_t
+	{
+		std::string out;
+		std::string err;
+		bool done;
+	};
+	std::vector<result_t> results(selection.size(), result_t{{}, {}, false});
+	std::size_t next_flush = 0;
+	std::mutex flush_mutex;
+	std::condition_variable flushed;
+
+	worker_pool pool(jobs);
+	for(std::size_t i = 0; i < selection.size(); ++i)
+	{
+		if(settings.max_resident)
+		{
+			// wait here rather than in the task, so no worker is held up
+			std::unique_lock<std::mutex> lock(flush_mutex);
+			flushed.wait(lock, [&]{ return i < next_flush + settings.max_resident; });
+		}
+
+		pool.run([&, i]
+		{
+			std::ostringstream out;
+			std::ostringstream err;
+			auto project = selection[i];
+			auto project_timings = timings ? &(*timings)[project] : nullptr;
+			auto kept = settings.models ? &(*settings.models)[project] : nullptr;
+			outcomes[project] = convert(projects[project], settings, out, err, project_timings, kept);
+			if(project_timings)
+				project_timings->status = to_string(outcomes[project]);
+
+			std::lock_guard<std::mutex> lock(flush_mutex);
+			results[i].out = out.str();
+			results[i].err = err.str();
+			results[i].done = true;
+
+			for(; next_flush < results.size() && results[next_flush].done; ++next_flush)
+			{
+				auto& result = results[next_flush];
+				std::cout << result.out << std::flush;
+				std::cerr << result.err << std::flush;
+				result.out.clear();
+				result.out.shrink_to_fit();
+				result.err.clear();
+				result.err.shrink_to_fit();
+			}
+			flushed.notify_one();
+		});
+	}
+	pool.wait();
+}
+
+// Converts the selected projects, in parallel when there are jobs to
+// spare. outcomes and timings are indexed like projects.
+void convert_projects(const std::vector<std::string>& projects, const std::vector<std::size_t>& selection, conversion_settings settings,
+		unsigned int jobs, std::vector<outcome>& outcomes, std::vector<project_timings>* timings)
+{
+	if(jobs > 1 && selection.size() > 1)
+	{
+		// jobs left over after one per project go to walking source trees.
+		auto project_jobs = std::min<std::size_t>(jobs, selection.size());
+		settings.opts.discovery_threads = jobs / project_jobs;
+		convert_parallel(projects, selection, settings, project_jobs, outcomes, timings);
+		return;
+	}
+
+	settings.opts.discovery_threads = jobs;
+	for(auto project : selection)
+	{
+		auto project_timings = timings ? &(*timings)[project] : nullptr;
+		auto kept = settings.models ? &(*settings.models)[project] : nullptr;
+		outcomes[project] = convert(projects[project], settings, std::cout, std::cerr, project_timings, kept);
+		if(project_timings)
+			project_timings->status = to_string(outcomes[project]);
+	}
+}
+
+/*
+ * Builds the models of all the selected projects before rendering any,
+ * so that settings blocks used by several projects can be shared, and
+ * returns the definitions of the shared blocks. Every model is held in
+ * memory until its listfile is written, in selection order.
+ */
+cmake::shared_settings convert_sharing(const std::vector<std::string>& projects, const std::vector<std::size_t>& selection, conversion_settings settings,
+		unsigned int jobs, std::vector<outcome>& outcomes, std::vector<project_timings>* timings)
+{
+	std::vector<cmake::project_model> models(selection.size());
+	std::vector<cmake::result> results(selection.size());
+	std::vector<std::string> errors(selection.size());
+
+	auto extract = [&](std::size_t i)
+	{
+		auto project = selection[i];
+		try
+		{
+			models[i] = extract_project(projects[project], settings, results[i], timings ? &(*timings)[project] : nullptr);
+			outcomes[project] = outcome::converted;
+		}
+		catch(const std::exception& ex)
+		{
+			errors[i] = ex.what();
+			outcomes[project] = outcome::failed;
+		}
+	};
+
+	if(jobs > 1 && selection.size() > 1)
+	{
+		auto project_jobs = std::min<std::size_t>(jobs, selection.size());
+		settings.opts.discovery_threads = jobs / project_jobs;
+		worker_pool pool(project_jobs);
+		for(std::size_t i = 0; i < selection.size(); ++i)
+			pool.run([&, i]{ extract(i); });
+		pool.wait();
+	}
+	else
+	{
+		settings.opts.discovery_threads = jobs;
+		for(std::size_t i = 0; i < selection.size(); ++i)
+			extract(i);
+	}
+
+	std::vector<cmake::project_model*> extracted;
+	for(std::size_t i = 0; i < selection.size(); ++i)
+	{
+		if(errors[i].empty())
+			extracted.push_back(&models[i]);
+	}
+	auto shared = cmake::share_settings(extracted, settings.shared_settings);
+
+	for(std::size_t i = 0; i < selection.size(); ++i)
+	{
+		auto project = selection[i];
+		auto project_timings = timings ? &(*timings)[project] : nullptr;
+		if(errors[i].empty())
+		{
+			try
+			{
+				cmake::render(models[i], settings.opts, std::cout, results[i], project_timings);
+				if(results[i].listfile_unchanged)
+					outcomes[project] = outcome::unchanged;
+			}
+			catch(const std::exception& ex)
+			{
+				errors[i] = ex.what();
+				outcomes[project] = outcome::failed;
+			}
+			models[i] = cmake::project_model();
+		}
+		if(!errors[i].empty())
+			std::cerr << "Error: " << errors[i] << "\n";
+		if(project_timings)
+			project_timings->status = to_string(outcomes[project]);
+	}
+	return shared;
+}
+
+/*
+ * Converts projects in waves so that every project follows the projects
+ * it references, then adds a listfile in their common parent folder that
+ * includes them in that order. Returns false if the order has cycles.
+ */
+bool convert_workspace(const std::vector<std::string>& projects, const conversion_settings& settings, unsigned int jobs,
+		std::vector<outcome>& outcomes, std::vector<project_timings>* timings)
+{
+	auto workspace = load_workspace(projects, jobs);
+	auto order = order_by_dependencies(workspace);
+
+	for(auto& cycle : order.cycles)
+	{
+		std::cerr << "Error: dependency cycle: ";
+		for(auto project : cycle)
+			std::cerr << workspace[project].name << " -> ";
+		std::cerr << workspace[cycle.front()].name << "\n";
+	}
+
+	// projects caught in or behind a cycle still get converted, last
+	if(!order.unordered.empty())
+		order.waves.push_back(order.unordered);
+
+	auto parent = common_parent(projects);
+	bool top_level = std::find(projects.begin(), projects.end(), parent) == projects.end();
+
+	// shared settings are defined in the top level listfile
+	std::vector<std::string> ordered_paths;
+	cmake::shared_settings shared{{}, "2.8"};
+	if(settings.shared_settings && top_level)
+	{
+		std::vector<std::size_t> ordered;
+		for(auto& wave : order.waves)
+			ordered.insert(ordered.end(), wave.begin(), wave.end());
+		shared = convert_sharing(projects, ordered, settings, jobs, outcomes, timings);
+		for(auto project : ordered)
+			ordered_paths.push_back(projects[project]);
+	}
+	else
+	{
+		for(auto& wave : order.waves)
+		{
+			convert_projects(projects, wave, settings, jobs, outcomes, timings);
+			for(auto project : wave)
+				ordered_paths.push_back(projects[project]);
+		}
+	}
+
+	if(!top_level)
+	{
+		std::cerr << "Error: " << parent << " is itself a project; not writing a top level CMakeLists.txt\n";
+		return order.cycles.empty();
+	}
+
+	auto listfile = top_level_listfile(parent, ordered_paths, shared.definitions, shared.minimum_version);
+	if(settings.opts.write_files)
+	{
+		auto filename = (parent.empty() ? std::string("./") : parent) + "CMakeLists.txt";
+		if(write_file_if_changed(filename, listfile) == write_result::failed)
+			std::cerr << "Error: unable to write " << filename << "\n";
+	}
+	else
+	{
+		std::cout << listfile;
+	}
+	return order.cycles.empty();
+}
+
+/*
+ * Writes a compilation database for the projects to filename, replacing
+ * it only once complete. Returns false if any project failed.
+ */
+bool export_compile_commands(const std::vector<std::string>& projects, const std::string& filename, const std::string& configuration,
+		const std::vector<std::string>& ignored, unsigned int jobs)
+{
+	auto temp_name = filename + ".tmp";
+	std::ofstream out(temp_name);
+	if(!out)
+	{
+		std::cerr << "Error: unable to write " << temp_name << "\n";
+		return false;
+	}
+
+	bool ok = true;
+	compile_commands_writer writer(out);
+	for(auto& project : projects)
+	{
+		try
+		{
+			cdt::project cdtproject(project);
+			write_compile_commands(cdtproject, configuration, ignored, jobs, writer);
+		}
+		catch(const std::exception& ex)
+		{
+			std::cerr << "Error: " << project << ": " << ex.what() << "\n";
+			ok = false;
+		}
+	}
+	writer.finish();
+	out.close();
+
+	if(!out || std::rename(temp_name.c_str(), filename.c_str()) != 0)
+	{
+		std::cerr << "Error: unable to write " << filename << "\n";
+		std::remove(temp_name.c_str());
+		return false;
+	}
+	std::cerr << writer.size() << " compile commands written to " << filename << "\n";
+	return ok;
+}
+
+// Appends the NUL separated project folders read from filename, or
+// from stdin for "-". Returns false if it cannot be read.
+bool read_project_list(const std::string& filename, std::vector<std::string>& projects)
+{
+	std::ifstream file;
+	std::istream* in = &std::cin;
+	if(filename != "-")
+	{
+		file.open(filename, std::ios::binary);
+		if(!file)
+			return false;
+		in = &file;
+	}
+
+	std::string path;
+	while(std::getline(*in, path, '\0'))
+		projects.push_back(path);
+	return !in->bad();
+}
+
+// kind:size[,kind:size]... with kind one of compile, executable, static, shared.
+bool parse_job_pools(const std::string& spec, cmake::job_pools& pools)
+{
+	std::istringstream entries(spec);
+	std::string entry;
+	while(std::getline(entries, entry, ','))
+	{
+		auto colon = entry.find(':');
+		if(colon == std::string::npos)
+			return false;
+		auto kind = entry.substr(0, colon);
+
+		unsigned int size;
+		try
+		{
+			std::size_t end;
+			size = std::stoul(entry.substr(colon + 1), &end);
+			if(end != entry.size() - colon - 1)
+				return false;
+		}
+		catch(const std::exception&)
+		{
+			return false;
+		}
+
+		if(kind == "compile")
+			pools.compile = size;
+		else if(kind == "executable")
+			pools.link_executable = size;
+		else if(kind == "static")
+			pools.link_static = size;
+		else if(kind == "shared")
+			pools.link_shared = size;
+		else
+			return false;
+	}
+	return true;
+}
+
 int main(int argc, char* argv[])
 {
 	std::vector<std::string> args{argv, argv+argc};
@@ -24,7 +487,19 @@ int main(int argc, char* argv[])
 	std::string program_name = args[0];
 	args.erase(begin(args));
 
-	bool generate(false);
+	conversion_settings settings;
+	auto& opts = settings.opts;
+	unsigned int jobs(1);
+	bool use_cache(false);
+	std::string cache_manifest;
+	std::string timings_format;
+	std::string timings_file;
+	bool dependency_ordered(false);
+	bool watch(false);
+	std::string compile_commands;
+	std::string configuration;
+	std::vector<std::string> workspace_roots;
+	std::string projects_from;
 	std::vector<std::string> projects;
 
 	for(auto it = begin(args); it != end(args); ++it)
@@ -44,7 +519,252 @@ int main(int argc, char* argv[])
 		{
 			if(arg == "--generate")
 			{
-				generate = true;
+				opts.write_files = true;
+			}
+			else if(arg == "--jobs" || arg.find("--jobs=") == 0)
+			{
+				std::string value;
+				if(arg == "--jobs")
+				{
+					if(++it == end(args))
+					{
+						std::cout << "Missing value for --jobs\n";
+						usage(program_name);
+						return 1;
+					}
+					value = *it;
+				}
+				else
+				{
+					value = arg.substr(7);
+				}
+
+				try
+				{
+					jobs = std::stoul(value);
+				}
+				catch(const std::exception&)
+				{
+					std::cout << "Invalid value for --jobs: " << value << "\n";
+					usage(program_name);
+					return 1;
+				}
+				if(jobs == 0)
+					jobs = worker_pool::default_concurrency();
+			}
+			else if(arg == "--max-resident-projects" || arg.find("--max-resident-projects=") == 0)
+			{
+				std::string value;
+				if(arg == "--max-resident-projects")
+				{
+					if(++it == end(args))
+					{
+						std::cout << "Missing value for --max-resident-projects\n";
+						usage(program_name);
+						return 1;
+					}
+					value = *it;
+				}
+				else
+				{
+					value = arg.substr(24);
+				}
+
+				try
+				{
+					settings.max_resident = std::stoul(value);
+				}
+				catch(const std::exception&)
+				{
+					std::cout << "Invalid value for --max-resident-projects: " << value << "\n";
+					usage(program_name);
+					return 1;
+				}
+			}
+			else if(arg == "--cache")
+			{
+				use_cache = true;
+			}
+			else if(arg.find("--cache=") == 0)
+			{
+				use_cache = true;
+				cache_manifest = arg.substr(8);
+			}
+			else if(arg == "--build-settings")
+			{
+				opts.build_settings = true;
+			}
+			else if(arg == "--pch")
+			{
+				opts.precompiled_headers = true;
+			}
+			else if(arg == "--unity")
+			{
+				opts.unity_build = true;
+			}
+			else if(arg.find("--unity=") == 0)
+			{
+				auto value = arg.substr(8);
+				try
+				{
+					opts.unity_batch_size = std::stoul(value);
+				}
+				catch(const std::exception&)
+				{
+					std::cout << "Invalid value for --unity: " << value << "\n";
+					usage(program_name);
+					return 1;
+				}
+				opts.unity_build = true;
+			}
+			else if(arg == "--job-pools")
+			{
+				// shared libraries link one at a time
+				opts.pools.link_shared = 1;
+			}
+			else if(arg.find("--job-pools=") == 0)
+			{
+				auto value = arg.substr(12);
+				if(!parse_job_pools(value, opts.pools))
+				{
+					std::cout << "Invalid value for --job-pools: " << value << "\n";
+					usage(program_name);
+					return 1;
+				}
+			}
+			else if(arg == "--workspace" || arg.find("--workspace=") == 0 || arg == "--projects-from" || arg.find("--projects-from=") == 0)
+			{
+				auto equals = arg.find('=');
+				auto option = arg.substr(0, equals);
+				std::string value;
+				if(equals == std::string::npos)
+				{
+					if(++it == end(args))
+					{
+						std::cout << "Missing value for " << option << "\n";
+						usage(program_name);
+						return 1;
+					}
+					value = *it;
+				}
+				else
+				{
+					value = arg.substr(equals + 1);
+				}
+
+				if(value.empty())
+				{
+					std::cout << "Missing value for " << option << "\n";
+					usage(program_name);
+					return 1;
+				}
+				if(option == "--workspace")
+					workspace_roots.push_back(value);
+				else
+					projects_from = value;
+			}
+			else if(arg == "--shared-settings")
+			{
+				settings.shared_settings = 2;
+			}
+			else if(arg.find("--shared-settings=") == 0)
+			{
+				auto value = arg.substr(18);
+				try
+				{
+					settings.shared_settings = std::stoul(value);
+				}
+				catch(const std::exception&)
+				{
+					std::cout << "Invalid value for --shared-settings: " << value << "\n";
+					usage(program_name);
+					return 1;
+				}
+			}
+			else if(arg.find("--compiler-launcher=") == 0)
+			{
+				opts.compiler_launcher = arg.substr(20);
+				if(opts.compiler_launcher.empty())
+				{
+					std::cout << "Missing value for --compiler-launcher\n";
+					usage(program_name);
+					return 1;
+				}
+			}
+			else if(arg == "--ignore" || arg.find("--ignore=") == 0)
+			{
+				std::string value;
+				if(arg == "--ignore")
+				{
+					if(++it == end(args))
+					{
+						std::cout << "Missing value for --ignore\n";
+						usage(program_name);
+						return 1;
+					}
+					value = *it;
+				}
+				else
+				{
+					value = arg.substr(9);
+				}
+
+				std::istringstream names(value);
+				std::string name;
+				while(std::getline(names, name, ','))
+				{
+					if(!name.empty())
+						opts.ignored.push_back(name);
+				}
+			}
+			else if(arg == "--dependency-order")
+			{
+				dependency_ordered = true;
+			}
+			else if(arg.find("--compile-commands=") == 0)
+			{
+				compile_commands = arg.substr(19);
+			}
+			else if(arg == "--configuration" || arg.find("--configuration=") == 0)
+			{
+				if(arg == "--configuration")
+				{
+					if(++it == end(args))
+					{
+						std::cout << "Missing value for --configuration\n";
+						usage(program_name);
+						return 1;
+					}
+					configuration = *it;
+				}
+				else
+				{
+					configuration = arg.substr(16);
+				}
+			}
+			else if(arg == "--watch")
+			{
+				watch = true;
+			}
+			else if(arg == "--timings")
+			{
+				timings_format = "text";
+			}
+			else if(arg.find("--timings=") == 0)
+			{
+				timings_format = arg.substr(10);
+				auto separator = timings_format.find(':');
+				if(separator != std::string::npos)
+				{
+					timings_file = timings_format.substr(separator + 1);
+					timings_format.resize(separator);
+				}
+				if((timings_format != "text" && timings_format != "json") || (separator != std::string::npos && timings_file.empty()))
+				{
+					std::cout << "Invalid value for --timings: " << arg.substr(10) << "\n";
+					usage(program_name);
+					return 1;
+				}
 			}
 			else if(arg == "--help")
 			{
@@ -64,6 +784,19 @@ int main(int argc, char* argv[])
 		}
 	}
 
+	if(!projects_from.empty() && !read_project_list(projects_from, projects))
+	{
+		std::cerr << "Error: unable to read " << projects_from << "\n";
+		return 1;
+	}
+	for(auto& root : workspace_roots)
+	{
+		auto found = find_projects(root, opts.ignored, jobs);
+		if(found.empty())
+			std::cerr << "Warning: no projects found under " << root << "\n";
+		projects.insert(projects.end(), found.begin(), found.end());
+	}
+
 	projects.erase(std::remove_if(begin(projects), end(projects), [](const std::string& project){ return project.empty(); }), projects.end());
 
 	if(projects.empty())
@@ -78,28 +811,181 @@ int main(int argc, char* argv[])
 			project += '/';
 	});
 
-	for(auto project_base : projects)
+	if(!compile_commands.empty())
+		return export_compile_commands(projects, compile_commands, configuration, opts.ignored, jobs) ? 0 : 1;
+
+	if(settings.shared_settings && (!dependency_ordered || use_cache || watch))
+	{
+		std::cout << "--shared-settings requires --dependency-order, without --cache or --watch\n";
+		usage(program_name);
+		return 1;
+	}
+
+	if(watch && !opts.write_files)
+	{
+		std::cout << "--watch requires --generate\n";
+		usage(program_name);
+		return 1;
+	}
+
+	std::unique_ptr<conversion_cache> workspace_cache;
+	if(use_cache)
+	{
+		if(!opts.write_files)
+		{
+			std::cout << "--cache requires --generate\n";
+			usage(program_name);
+			return 1;
+		}
+
+		opts.record_directories = true;
+		if(cache_manifest.empty())
+		{
+			settings.project_cache = true;
+		}
+		else
+		{
+			workspace_cache.reset(new conversion_cache(cache_manifest));
+			workspace_cache->load();
+			settings.workspace_cache = workspace_cache.get();
+		}
+	}
+
+	std::vector<project_timings> timings;
+	if(!timings_format.empty())
+	{
+		timings.resize(projects.size());
+		for(std::size_t i = 0; i < projects.size(); ++i)
+			timings[i].project = projects[i];
+	}
+	auto run_start = process_now();
+
+	// the watcher carries on from the models built here
+	std::vector<cmake::project_model> models;
+	if(watch)
+	{
+		models.resize(projects.size());
+		settings.models = &models;
+	}
+
+	int status = 0;
+	std::vector<outcome> outcomes(projects.size(), outcome::failed);
+	auto timings_out = timings_format.empty() ? nullptr : &timings;
+	if(dependency_ordered)
+	{
+		if(!convert_workspace(projects, settings, jobs, outcomes, timings_out))
+			status = 1;
+	}
+	else
+	{
+		std::vector<std::size_t> selection(projects.size());
+		for(std::size_t i = 0; i < selection.size(); ++i)
+			selection[i] = i;
+		convert_projects(projects, selection, settings, jobs, outcomes, timings_out);
+	}
+
+	if(workspace_cache && !workspace_cache->save())
+		std::cerr << "Warning: unable to write " << cache_manifest << "\n";
+
+	auto up_to_date = std::count(outcomes.begin(), outcomes.end(), outcome::up_to_date);
+	if(use_cache)
+		std::cerr << up_to_date << " of " << projects.size() << " projects up to date\n";
+	if(opts.write_files)
+	{
+		auto unchanged = up_to_date + std::count(outcomes.begin(), outcomes.end(), outcome::unchanged);
+		std::cerr << unchanged << " of " << projects.size() << " CMakeLists.txt files unchanged\n";
+	}
+
+	if(!timings_format.empty())
+	{
+		auto run = process_now();
+		run.wall -= run_start.wall;
+		run.cpu -= run_start.cpu;
+
+		// a report written to a file is kept apart from the status lines
+		std::ostringstream report;
+		std::ostream& os = timings_file.empty() ? std::cerr : report;
+		const std::size_t slowest = 10;
+		if(timings_format == "json")
+			write_json(os, timings, run, slowest);
+		else
+			write_summary(os, timings, run, slowest);
+
+		if(!timings_file.empty() && !write_file_atomic(timings_file, report.str()))
+		{
+			std::cerr << "Error: unable to write " << timings_file << "\n";
+			status = 1;
+		}
+	}
+
+	if(watch)
 	{
+		watch_settings resident;
+		resident.jobs = jobs;
 		try
 		{
-			cdt::project cdtproject(project_base);
-			cmake::generate(cdtproject, generate);
+			watch_projects(projects, models, opts, resident);
 		}
 		catch(const std::exception& ex)
 		{
 			std::cerr << "Error: " << ex.what() << "\n";
+			return 1;
 		}
 	}
-	return 0;
+	return status;
 }
 
 void usage(const std::string& program_name)
 {
-	std::cout << "Usage: " << program_name << " [OPTIONS]... /path/to/eclipse-cdt/project/...\n";
+	std::cout << "Usage: " << program_name << " [OPTIONS]... [/path/to/eclipse-cdt/project/...]\n";
 	std::cout << "Converts CDT project file descriptions to CMakeLists.txt files.\n";
 	std::cout << "By default no changes are made to the project source path.\n\n";
 
+	std::cout << "  --workspace ROOT        convert every project found below ROOT, besides\n";
+	std::cout << "                          the projects given. May be repeated.\n";
+	std::cout << "  --projects-from FILE    also convert the NUL separated project folders in\n";
+	std::cout << "                          FILE, or on stdin for -, as from find -print0.\n";
 	std::cout << "  --generate              Generate the CMakeLists.txt files\n";
 	std::cout << "                          in their appropriate source locations.\n";
+	std::cout << "  --jobs N                convert up to N projects in parallel.\n";
+	std::cout << "                          0 uses one job per hardware thread.\n";
+	std::cout << "                          Output is still written in argument order.\n";
+	std::cout << "  --max-resident-projects N\n";
+	std::cout << "                          with --jobs, hold at most N projects in memory,\n";
+	std::cout << "                          converting or waiting for their output to be written.\n";
+	std::cout << "  --cache[=FILE]          skip projects unchanged since the last --generate.\n";
+	std::cout << "                          State is kept in .cdt2cmake.cache in each project,\n";
+	std::cout << "                          or for all projects in FILE.\n";
+	std::cout << "  --build-settings        also emit the defines, optimization, debugging,\n";
+	std::cout << "                          language standard and PIC of the configurations.\n";
+	std::cout << "  --pch                   use headers force included with -include, or a\n";
+	std::cout << "                          pch.h or stdafx.h in the tree, as precompiled headers.\n";
+	std::cout << "  --unity[=N]             build each target as a unity build, combining\n";
+	std::cout << "                          the sources of each folder, or N sources at a time.\n";
+	std::cout << "  --job-pools[=POOLS]     limit concurrent Ninja jobs with JOB_POOLS. POOLS is\n";
+	std::cout << "                          a list of KIND:N with KIND compile, executable,\n";
+	std::cout << "                          static or shared (link jobs); default shared:1.\n";
+	std::cout << "  --compiler-launcher=TOOL compile through TOOL (e.g. ccache) when CMake finds\n";
+	std::cout << "                          it, with compile flags in a stable order and paths\n";
+	std::cout << "                          relative to ${CMAKE_SOURCE_DIR} for more cache hits.\n";
+	std::cout << "  --ignore NAMES          do not search directories with these comma separated\n";
+	std::cout << "                          names for sources or, with --workspace, projects.\n";
+	std::cout << "                          .git, .hg, .svn and the build folder of each\n";
+	std::cout << "                          configuration are always skipped.\n";
+	std::cout << "  --dependency-order      convert projects after the projects they reference\n";
+	std::cout << "                          and write a top level CMakeLists.txt in their\n";
+	std::cout << "                          common parent folder adding them in that order.\n";
+	std::cout << "  --shared-settings[=N]   with --dependency-order, define compile and link\n";
+	std::cout << "                          settings used alike by N projects (default 2) once,\n";
+	std::cout << "                          as INTERFACE libraries in the top level listfile.\n";
+	std::cout << "  --compile-commands=FILE write a compile_commands.json for the projects to\n";
+	std::cout << "                          FILE instead of converting them.\n";
+	std::cout << "  --configuration NAME    export the configuration NAME (default: the first).\n";
+	std::cout << "  --watch                 after converting, keep running and regenerate the\n";
+	std::cout << "                          CMakeLists.txt of a project when its descriptors\n";
+	std::cout << "                          change or source files are added or removed.\n";
+	std::cout << "  --timings[=FORMAT[:FILE]] report wall and CPU time per phase and project,\n";
+	std::cout << "                          with the slowest projects, as text or json on\n";
+	std::cout << "                          stderr or in FILE.\n";
 	std::cout << "  --help                  display this help and exit\n";
 }
@@ -40,6 +40,35 @@ configuration_t::Type resolve_artifact_type(const std::string& artifact_type)
 		throw std::runtime_error("Unknown artifact type: " + artifact_type);
 }
 
+namespace
+{
+
+std::string trim_slashes(const std::string& path)
+{
+	auto first = path.find_first_not_of('/');
+	if(first == std::string::npos)
+		return {};
+	return path.substr(first, path.find_last_not_of('/') + 1 - first);
+}
+
+}
+
+configuration_t::source_entry resolve_source_entry(const std::string& name, const std::string& excluding)
+{
+	configuration_t::source_entry entry;
+	entry.path = trim_slashes(name);
+
+	std::istringstream paths(excluding);
+	std::string path;
+	while(std::getline(paths, path, '|'))
+	{
+		path = trim_slashes(path);
+		if(!path.empty())
+			entry.excluding.emplace_back(path);
+	}
+	return entry;
+}
+
 std::ostream& operator<<(std::ostream& os, const configuration_t& conf)
 {
 	os << "{\n";
@@ -68,6 +97,9 @@ std::ostream& operator<<(std::ostream& os, const configuration_t& conf)
 	for(auto& bf : conf.build_files)
 		os << bf;
 
+	for(auto& entry : conf.source_entries)
+		os << entry;
+
 	os << "}\n";
 	return os;
 }
@@ -90,6 +122,13 @@ std::ostream& operator<<(std::ostream& os, const configuration_t::build_file& bf
 	os << "}\n";
 	return os;
 }
+std::ostream& operator<<(std::ostream& os, const configuration_t::source_entry& entry)
+{
+	os << "source: '" << entry.path << "' excluding: ";
+	std::copy(entry.excluding.begin(), entry.excluding.end(), std::ostream_iterator<std::string>(os, ", "));
+	os << "\n";
+	return os;
+}
 std::ostream& operator<<(std::ostream& os, const configuration_t::build_folder::compiler_t& c)
 {
 	os << "{\n";
@@ -98,7 +137,15 @@ std::ostream& operator<<(std::ostream& os, const configuration_t::build_folder::
 	std::copy(c.includes.begin(), c.includes.end(), std::ostream_iterator<std::string>(os, ", "));
 	os << "\n";
 
+	os << "      defines: ";
+	std::copy(c.defines.begin(), c.defines.end(), std::ostream_iterator<std::string>(os, ", "));
+	os << "\n";
+
 	os << "      options: " << c.options << "\n";
+	os << "      optimization: " << c.optimization << "\n";
+	os << "      debugging: " << c.debugging << "\n";
+	os << "      standard: " << c.standard << "\n";
+	os << "      pic: " << (c.pic ? "true" : "false") << "\n";
 
 	os << "   }\n";
 	return os;
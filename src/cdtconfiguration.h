@@ -10,17 +10,23 @@
 #include <string>
 #include <vector>
 #include <ostream>
+#include "orderedset.h"
+#include "istring.h"
 
 namespace cdt
 {
 
+/*
+ * Strings in the model are interned: the same paths, libraries and flags
+ * recur across every configuration of a workspace.
+ */
 struct configuration_t
 {
-	std::string name;
-	std::string artifact;
+	istring name;
+	istring artifact;
 
-	std::string prebuild;
-	std::string postbuild;
+	istring prebuild;
+	istring postbuild;
 
 	enum class Type
 	{
@@ -31,18 +37,25 @@ struct configuration_t
 
 	struct build_folder
 	{
-		std::string path;
+		istring path;
 
 		struct compiler_t
 		{
-			std::vector<std::string> includes;
-			std::string options;
+			ordered_set<istring> includes;
+			ordered_set<istring> defines;
+			istring options;
+
+			// flags for enumerated options, empty when not set
+			istring optimization;
+			istring debugging;
+			istring standard;
+			bool pic = false;
 		};
 		struct linker_t
 		{
-			std::string flags;
-			std::vector<std::string> libs;
-			std::vector<std::string> lib_paths;
+			istring flags;
+			ordered_set<istring> libs;
+			ordered_set<istring> lib_paths;
 		};
 
 		struct
@@ -62,22 +75,39 @@ struct configuration_t
 
 	struct build_file
 	{
-		std::string file;
-		std::string command;
-		std::string inputs;
-		std::string outputs;
+		istring file;
+		istring command;
+		istring inputs;
+		istring outputs;
 	};
 
 	std::vector<build_file> build_files;
+
+	/*
+	 * Source folders from sourceEntries, relative to the project ("" for
+	 * the project itself), each with the paths below it, relative to the
+	 * entry, that are not sources. No entries means the whole project.
+	 */
+	struct source_entry
+	{
+		istring path;
+		std::vector<istring> excluding;
+	};
+
+	std::vector<source_entry> source_entries;
 };
 
 std::string to_string(configuration_t::Type t);
 
 configuration_t::Type resolve_artifact_type(const std::string& artifact_type);
 
+// From the name and excluding attributes of a sourcePath entry.
+configuration_t::source_entry resolve_source_entry(const std::string& name, const std::string& excluding);
+
 std::ostream& operator<<(std::ostream& os, const configuration_t& conf);
 std::ostream& operator<<(std::ostream& os, const configuration_t::build_folder& bf);
 std::ostream& operator<<(std::ostream& os, const configuration_t::build_file& bf);
+std::ostream& operator<<(std::ostream& os, const configuration_t::source_entry& entry);
 std::ostream& operator<<(std::ostream& os, const configuration_t::build_folder::compiler_t& c);
 std::ostream& operator<<(std::ostream& os, const configuration_t::build_folder::linker_t& l);
 
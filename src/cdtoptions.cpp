@@ -0,0 +1,318 @@
+/*
+ * cdtoptions.cpp
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#include "cdtoptions.h"
+#include <array>
+
+namespace cdt
+{
+
+namespace
+{
+
+/*
+ * Aho-Corasick automaton over a fixed keyword list, compiled to a full
+ * transition table so a superClass is classified in one pass of one
+ * table lookup per character. When several keywords occur in the same
+ * text the one listed first wins.
+ */
+class keyword_matcher
+{
+public:
+	template <typename Entry, std::size_t N>
+	explicit keyword_matcher(const Entry (&table)[N])
+	 : states(1), match(1, -1)
+	{
+		for(std::size_t keyword = 0; keyword < N; ++keyword)
+			add(table[keyword].keyword, keyword);
+		link();
+	}
+
+	// Index of the first listed keyword found in text, or -1.
+	int find(const char* text, std::size_t size) const
+	{
+		int found = -1;
+		std::size_t state = 0;
+		for(auto end = text + size; text != end; ++text)
+		{
+			state = states[state][symbol(*text)];
+			auto keyword = match[state];
+			if(keyword >= 0 && (found < 0 || keyword < found))
+			{
+				found = keyword;
+				if(found == 0)
+					break;
+			}
+		}
+		return found;
+	}
+private:
+	// Keywords are lower case CDT id segments; every other character
+	// shares one symbol that never appears in a keyword.
+	static const std::size_t symbols = 38;
+	static std::size_t symbol(char c)
+	{
+		if(c >= 'a' && c <= 'z')
+			return 1 + (c - 'a');
+		if(c >= '0' && c <= '9')
+			return 27 + (c - '0');
+		if(c == '.')
+			return 37;
+		return 0;
+	}
+
+	std::vector<std::array<std::size_t, symbols>> states;
+	std::vector<int> match;
+
+	void add(const char* keyword, std::size_t index)
+	{
+		std::size_t state = 0;
+		for(; *keyword; ++keyword)
+		{
+			auto sym = symbol(*keyword);
+			std::size_t next = states[state][sym];
+			if(!next)
+			{
+				// emplace_back may move states, so no reference is held
+				next = states.size();
+				states.emplace_back();
+				match.push_back(-1);
+				states[state][sym] = next;
+			}
+			state = next;
+		}
+		if(match[state] < 0)
+			match[state] = index;
+	}
+
+	// Replaces missing transitions with those of the longest proper
+	// suffix in the trie, breadth first so suffixes are complete first.
+	void link()
+	{
+		std::vector<std::size_t> fail(states.size(), 0);
+		std::vector<std::size_t> queue;
+		for(auto next : states[0])
+		{
+			if(next)
+				queue.push_back(next);
+		}
+
+		for(std::size_t i = 0; i < queue.size(); ++i)
+		{
+			auto state = queue[i];
+			auto suffix = fail[state];
+			if(match[suffix] >= 0 && (match[state] < 0 || match[suffix] < match[state]))
+				match[state] = match[suffix];
+
+			for(std::size_t c = 0; c < symbols; ++c)
+			{
+				auto& next = states[state][c];
+				if(next)
+				{
+					fail[next] = states[suffix][c];
+					queue.push_back(next);
+				}
+				else
+				{
+					next = states[suffix][c];
+				}
+			}
+		}
+	}
+};
+
+struct tool_keyword
+{
+	const char* keyword;
+	tool_kind kind;
+};
+
+const tool_keyword tool_keywords[] =
+{
+	{"cpp.compiler", tool_kind::cpp_compiler},
+	{"c.compiler", tool_kind::c_compiler},
+	{"cpp.linker", tool_kind::cpp_linker},
+	{"c.linker", tool_kind::c_linker}
+};
+
+struct option_keyword
+{
+	const char* keyword;
+	option_kind kind;
+};
+
+const option_keyword option_keywords[] =
+{
+	{"compiler.option.include.paths", option_kind::include_paths},
+	{"compiler.option.preprocessor.def", option_kind::defines},
+	{"compiler.option.other.other", option_kind::other_flags},
+	{"option.optimization.level", option_kind::optimization_level},
+	{"option.debugging.level", option_kind::debugging_level},
+	{"compiler.option.other.pic", option_kind::pic},
+	{"compiler.option.misc.pic", option_kind::pic},
+	{"compiler.option.dialect.std", option_kind::language_standard},
+	{"link.option.libs", option_kind::libs},
+	{"link.option.paths", option_kind::lib_paths},
+	{"link.option.flags", option_kind::link_flags}
+};
+
+// Values of enumerated options end in a level name,
+// e.g. gnu.cpp.compiler.optimization.level.most
+struct level_flag
+{
+	const char* level;
+	const char* flag;
+};
+
+const level_flag optimization_levels[] =
+{
+	{"none", "-O0"},
+	{"optimize", "-O1"},
+	{"more", "-O2"},
+	{"most", "-O3"},
+	{"size", "-Os"}
+};
+
+const level_flag debugging_levels[] =
+{
+	{"none", ""},
+	{"minimal", "-g1"},
+	{"default", "-g"},
+	{"max", "-g3"}
+};
+
+template <std::size_t N>
+istring level_to_flag(const level_flag (&levels)[N], const std::string& value)
+{
+	auto level = value.substr(value.rfind('.') + 1);
+	for(auto& entry : levels)
+	{
+		if(level == entry.level)
+			return entry.flag;
+	}
+	return {};
+}
+
+// e.g. gnu.cpp.compiler.dialect.c++11
+istring standard_to_flag(const std::string& value)
+{
+	auto dialect = value.rfind("dialect.");
+	if(dialect == std::string::npos)
+		return {};
+	auto standard = value.substr(dialect + 8);
+	if(standard.empty() || standard == "default")
+		return {};
+	return "-std=" + standard;
+}
+
+void append(ordered_set<istring>& list, std::vector<std::string>& values)
+{
+	for(auto& value : values)
+		list.insert(value);
+	values.clear();
+}
+
+}
+
+tool_kind classify_tool(const char* superClass, std::size_t size)
+{
+	static const keyword_matcher matcher(tool_keywords);
+	auto keyword = matcher.find(superClass, size);
+	return keyword < 0 ? tool_kind::unknown : tool_keywords[keyword].kind;
+}
+tool_kind classify_tool(const std::string& superClass)
+{
+	return classify_tool(superClass.data(), superClass.size());
+}
+
+option_kind classify_option(const char* superClass, std::size_t size)
+{
+	static const keyword_matcher matcher(option_keywords);
+	auto keyword = matcher.find(superClass, size);
+	return keyword < 0 ? option_kind::unknown : option_keywords[keyword].kind;
+}
+option_kind classify_option(const std::string& superClass)
+{
+	return classify_option(superClass.data(), superClass.size());
+}
+
+void apply_option(option_t& option, configuration_t::build_folder::compiler_t& compiler)
+{
+	switch(option.kind)
+	{
+		case option_kind::include_paths:
+			append(compiler.includes, option.list_values);
+			break;
+		case option_kind::defines:
+			append(compiler.defines, option.list_values);
+			break;
+		case option_kind::other_flags:
+			if(option.has_value)
+				compiler.options = option.value;
+			break;
+		case option_kind::optimization_level:
+			if(option.has_value)
+				compiler.optimization = level_to_flag(optimization_levels, option.value);
+			break;
+		case option_kind::debugging_level:
+			if(option.has_value)
+				compiler.debugging = level_to_flag(debugging_levels, option.value);
+			break;
+		case option_kind::pic:
+			if(option.has_value)
+				compiler.pic = option.value == "true";
+			break;
+		case option_kind::language_standard:
+			if(option.has_value)
+				compiler.standard = standard_to_flag(option.value);
+			break;
+		default:
+			break;
+	}
+}
+
+void apply_option(option_t& option, configuration_t::build_folder::linker_t& linker)
+{
+	switch(option.kind)
+	{
+		case option_kind::libs:
+			append(linker.libs, option.list_values);
+			break;
+		case option_kind::lib_paths:
+			append(linker.lib_paths, option.list_values);
+			break;
+		case option_kind::link_flags:
+			if(option.has_value)
+				linker.flags = option.value;
+			break;
+		default:
+			break;
+	}
+}
+
+void apply_option(tool_kind tool, option_t& option, configuration_t::build_folder& bf)
+{
+	switch(tool)
+	{
+		case tool_kind::c_compiler:
+			apply_option(option, bf.c.compiler);
+			break;
+		case tool_kind::cpp_compiler:
+			apply_option(option, bf.cpp.compiler);
+			break;
+		case tool_kind::c_linker:
+			apply_option(option, bf.c.linker);
+			break;
+		case tool_kind::cpp_linker:
+			apply_option(option, bf.cpp.linker);
+			break;
+		case tool_kind::unknown:
+			break;
+	}
+}
+
+}
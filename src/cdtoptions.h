@@ -0,0 +1,73 @@
+/*
+ * cdtoptions.h
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#ifndef CDTOPTIONS_H_
+#define CDTOPTIONS_H_
+#include <string>
+#include <vector>
+#include "cdtconfiguration.h"
+
+namespace cdt
+{
+
+/*
+ * Interpretation of <tool> and <option> elements shared by the DOM and
+ * the streaming .cproject readers.
+ */
+
+enum class tool_kind
+{
+	unknown,
+	c_compiler,
+	cpp_compiler,
+	c_linker,
+	cpp_linker
+};
+
+tool_kind classify_tool(const char* superClass, std::size_t size);
+tool_kind classify_tool(const std::string& superClass);
+
+enum class option_kind
+{
+	unknown,
+	include_paths,
+	defines,
+	other_flags,
+	optimization_level,
+	debugging_level,
+	pic,
+	language_standard,
+	libs,
+	lib_paths,
+	link_flags
+};
+
+/*
+ * Options are recognised by a segment of their superClass id, so that
+ * gnu.cpp.compiler.exe.debug.option.optimization.level and its
+ * gnu.c.compiler.so.release... siblings map to the same kind.
+ */
+option_kind classify_option(const char* superClass, std::size_t size);
+option_kind classify_option(const std::string& superClass);
+
+struct option_t
+{
+	option_kind kind = option_kind::unknown;
+	std::string value;
+	bool has_value = false;
+	std::vector<std::string> list_values;
+};
+
+void apply_option(option_t& option, configuration_t::build_folder::compiler_t& compiler);
+void apply_option(option_t& option, configuration_t::build_folder::linker_t& linker);
+
+// Applies the option to the compiler or linker selected by the tool kind.
+void apply_option(tool_kind tool, option_t& option, configuration_t::build_folder& bf);
+
+}
+
+#endif /* CDTOPTIONS_H_ */
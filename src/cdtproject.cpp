@@ -10,6 +10,9 @@
 #include <sstream>
 #include <iterator>
 #include "tixml_iterator.h"
+#include "cdtoptions.h"
+#include "xmlstream.h"
+#include "fileio.h"
 
 template <typename ex = std::runtime_error>
 void throw_if(bool cond, const std::string& what)
@@ -21,156 +24,289 @@ void throw_if(bool cond, const std::string& what)
 namespace cdt
 {
 
-project::project(const std::string& project_base)
- : project_path(project_base)
+namespace
 {
-	const std::string project_file = project_path + ".project";
-	const std::string cproject_file = project_path + ".cproject";
-
-	throw_if(!project_doc.LoadFile(project_file), "Unable to parse file " + project_file);
-	throw_if(!cproject_doc.LoadFile(cproject_file), "Unable to parse file " + cproject_file);
 
-	auto project_root = project_doc.RootElement();
-	throw_if(project_root->ValueStr() != "projectDescription", "Unrecognised root node in" + project_file);
-
-	auto cproject_root = cproject_doc.RootElement();
-	throw_if(cproject_root->ValueStr() != "cproject", "Unrecognised root node in" + cproject_file);
-}
-
-std::string project::path() const
+// Reads the children of <projects> or <natures>.
+void read_names(xml_reader& xml, const char* element, std::vector<std::string>& names)
 {
-	return project_path;
+	std::string text;
+	while(xml.next() == xml_reader::start_element)
+	{
+		if(xml.name() == element && xml.read_text(text))
+			names.push_back(text);
+		else if(xml.name() != element)
+			xml.skip();
+	}
 }
 
-std::string project::name()
+void stream_project_description(const char* begin, const char* end, const std::string& project_file, project_description& description)
 {
-	TiXmlHandle doc(&project_doc);
+	xml_reader xml(begin, end);
 
-	auto name = doc.FirstChildElement("projectDescription").FirstChildElement("name").ToElement();
-	throw_if(!name, "Missing /projectDescription/name");
+	if(xml.next() != xml_reader::start_element)
+		throw xml_error("Missing root node in " + project_file);
+	throw_if(xml.name() != "projectDescription", "Unrecognised root node in" + project_file);
 
-	auto project_name = name->GetText();
-	throw_if(!project_name, "Missing /projectDescription/name/CDATA");
+	bool have_name = false;
+	bool have_comment = false;
+	bool have_projects = false;
+	bool have_natures = false;
+	while(xml.next() == xml_reader::start_element)
+	{
+		if(!have_name && xml.name() == "name")
+		{
+			have_name = true;
+			throw_if(!xml.read_text(description.name), "Missing /projectDescription/name/CDATA");
+		}
+		else if(!have_comment && xml.name() == "comment")
+		{
+			have_comment = true;
+			xml.read_text(description.comment);
+		}
+		else if(!have_projects && xml.name() == "projects")
+		{
+			have_projects = true;
+			read_names(xml, "project", description.references);
+		}
+		else if(!have_natures && xml.name() == "natures")
+		{
+			have_natures = true;
+			read_names(xml, "nature", description.natures);
+		}
+		else
+		{
+			xml.skip();
+		}
+	}
+	throw_if(!have_name, "Missing /projectDescription/name");
 
-	return project_name;
+	if(xml.next() != xml_reader::end_document)
+		throw xml_error("Content after root node in " + project_file);
 }
 
-std::string project::comment()
+project_description dom_project_description(const std::string& project_file)
 {
-	TiXmlHandle doc(&project_doc);
+	TiXmlDocument project_doc;
+	throw_if(!project_doc.LoadFile(project_file), "Unable to parse file " + project_file);
 
-	auto comment = doc.FirstChildElement("projectDescription").FirstChildElement("comment").ToElement();
-	if(!comment)
-		return {};
+	auto root = project_doc.RootElement();
+	throw_if(root->ValueStr() != "projectDescription", "Unrecognised root node in" + project_file);
 
-	auto cmt = comment->GetText();
-	if(!cmt)
-		return {};
+	project_description description;
+
+	auto name = root->FirstChildElement("name");
+	throw_if(!name, "Missing /projectDescription/name");
+
+	auto text = name->GetText();
+	throw_if(!text, "Missing /projectDescription/name/CDATA");
+	description.name = text;
+
+	if(auto comment = root->FirstChildElement("comment"))
+	{
+		if(auto cmt = comment->GetText())
+			description.comment = cmt;
+	}
+
+	if(auto projects = root->FirstChildElement("projects"))
+	{
+		for(auto project : elements_named(projects, "project"))
+		{
+			if(auto name = project->GetText())
+				description.references.emplace_back(name);
+		}
+	}
 
-	return cmt;
+	if(auto natures = root->FirstChildElement("natures"))
+	{
+		for(auto nature : elements_named(natures, "nature"))
+		{
+			if(auto name = nature->GetText())
+				description.natures.emplace_back(name);
+		}
+	}
+	return description;
 }
 
-std::vector<std::string> project::referenced_projects()
+// Leaves value untouched when the attribute is missing.
+void query_attribute(const TiXmlElement* element, const char* name, istring& value)
 {
-	TiXmlHandle doc(&project_doc);
+	if(auto attribute = element->Attribute(name))
+		value = attribute;
+}
+
+}
 
-	auto projects = doc.FirstChildElement("projectDescription").FirstChildElement("projects").ToElement();
-	if(!projects)
-		return {};
+project_description read_project_description(const std::string& project_file)
+{
+	mapped_file file;
+	throw_if(!file.open(project_file), "Unable to parse file " + project_file);
 
-	std::vector<std::string> project_list;
-	for(auto project = projects->FirstChildElement("project"); project; project = project->NextSiblingElement("project"))
+	project_description description;
+	try
 	{
-		auto name = project->GetText();
-		if(!name)
-			continue;
-		project_list.emplace_back(name);
+		stream_project_description(file.begin(), file.end(), project_file, description);
+	}
+	catch(const xml_error&)
+	{
+		// Not something the streaming reader understands; use the DOM.
+		return dom_project_description(project_file);
 	}
-	return project_list;
+	return description;
 }
 
-std::vector<std::string> project::natures()
+project::project(const std::string& project_base)
+ : project_path(project_base), xml_size(0), cdt_settings(nullptr)
 {
-	TiXmlHandle doc(&project_doc);
+	const std::string project_file = project_path + ".project";
+	const std::string cproject_file = project_path + ".cproject";
 
-	auto natures = doc.FirstChildElement("projectDescription").FirstChildElement("natures").ToElement();
-	if(!natures)
-		return {};
+	description = read_project_description(project_file);
 
-	std::vector<std::string> nature_list;
-	for(auto nature : elements_named(natures, "nature"))
+	mapped_file cproject;
+	throw_if(!cproject.open(cproject_file), "Unable to parse file " + cproject_file);
+	xml_size = stat_file(project_file).size + cproject.size();
+	try
 	{
-		auto name = nature->GetText();
-		if(!name)
-			continue;
-		nature_list.emplace_back(name);
+		read_cproject(cproject.begin(), cproject.end(), cproject_file, description.name, cconfiguration_ids, configurations);
+	}
+	catch(const xml_error&)
+	{
+		// Not something the streaming reader understands; use the DOM.
+		cconfiguration_ids.clear();
+		configurations.clear();
+		load_cproject(cproject_file);
+
+		// Extract every configuration now so the document can go.
+		for(auto& id : cconfiguration_ids)
+		{
+			auto& extracted = configurations[id];
+			try
+			{
+				extracted.conf = dom_configuration(id);
+			}
+			catch(const std::runtime_error& ex)
+			{
+				extracted.error = ex.what();
+			}
+		}
+		cconfiguration_index.clear();
+		cdt_settings = nullptr;
+		cproject_doc.reset();
 	}
-	return nature_list;
 }
 
-TiXmlElement* project::settings()
+void project::load_cproject(const std::string& cproject_file)
 {
-	auto root = cproject_doc.RootElement();
+	cproject_doc.reset(new TiXmlDocument);
+	throw_if(!cproject_doc->LoadFile(cproject_file), "Unable to parse file " + cproject_file);
+
+	auto root = cproject_doc->RootElement();
+	throw_if(root->ValueStr() != "cproject", "Unrecognised root node in" + cproject_file);
+
 	for(auto storageModule : elements_named(root, "storageModule"))
 	{
 		auto moduleId  = storageModule->Attribute("moduleId");
 		if(moduleId && std::string(moduleId) == "org.eclipse.cdt.core.settings")
-			return storageModule;
+		{
+			cdt_settings = storageModule;
+			break;
+		}
 	}
-
-	return nullptr;
-}
-
-std::vector<std::string> project::cconfigurations()
-{
-	auto cdt_settings = settings();
 	if(!cdt_settings)
-		return {};
+		return;
 
-	std::vector<std::string> configs;
 	for(auto cconfiguration : elements_named(cdt_settings, "cconfiguration"))
 	{
 		auto id = cconfiguration->Attribute("id");
 		if(!id)
 			continue;
 
-		configs.emplace_back(id);
+		cconfiguration_entry entry{cconfiguration, nullptr};
+		for(auto storageModule : elements_named(cconfiguration, "storageModule"))
+		{
+			auto moduleId = storageModule->Attribute("moduleId");
+			if(moduleId && std::string(moduleId) == "cdtBuildSystem")
+			{
+				entry.buildsystem_configuration = storageModule->FirstChildElement("configuration");
+				break;
+			}
+		}
+
+		// first definition wins, as it did for the linear lookup.
+		if(cconfiguration_index.insert({id, entry}).second)
+			cconfiguration_ids.emplace_back(id);
 	}
+}
 
-	return configs;
+std::string project::path() const
+{
+	return project_path;
+}
+std::size_t project::descriptor_size() const
+{
+	return xml_size;
 }
 
-TiXmlElement* project::cconfiguration(const std::string& id)
+std::string project::name() const
 {
-	auto cdt_settings = settings();
-	if(!cdt_settings)
-		return nullptr;
+	return description.name;
+}
 
-	for(auto cconfiguration : elements_named(cdt_settings, "cconfiguration"))
-	{
-		auto cid = cconfiguration->Attribute("id");
-		if(!cid)
-			continue;
+std::string project::comment() const
+{
+	return description.comment;
+}
 
-		if(id == cid)
-			return cconfiguration;
-	}
+std::vector<std::string> project::referenced_projects() const
+{
+	return description.references;
+}
 
-	return nullptr;
+std::vector<std::string> project::natures() const
+{
+	return description.natures;
 }
 
-configuration_t project::configuration(const std::string& cconfiguration_id)
+TiXmlElement* project::settings() const
+{
+	return cdt_settings;
+}
+
+std::vector<std::string> project::cconfigurations() const
+{
+	return cconfiguration_ids;
+}
+
+TiXmlElement* project::cconfiguration(const std::string& id) const
+{
+	auto it = cconfiguration_index.find(id);
+	if(it == cconfiguration_index.end())
+		return nullptr;
+	return it->second.cconfiguration;
+}
+
+const configuration_t& project::configuration(const std::string& cconfiguration_id) const
+{
+
+	auto it = configurations.find(cconfiguration_id);
+	throw_if(it == configurations.end(), "Unable to read configuration");
+	throw_if(!it->second.error.empty(), it->second.error);
+	return it->second.conf;
+}
+
+configuration_t project::dom_configuration(const std::string& cconfiguration_id) const
 {
 	configuration_t conf;
 	auto configuration = cdtBuildSystem_configuration(cconfiguration_id);
 	throw_if(!configuration, "Unable to read configuration");
 
-	configuration->QueryStringAttribute("name", &conf.name);
-	configuration->QueryStringAttribute("artifactName", &conf.artifact);
+	query_attribute(configuration, "name", conf.name);
+	query_attribute(configuration, "artifactName", conf.artifact);
 	if(conf.artifact == "${ProjName}")
-		conf.artifact = name();
-	configuration->QueryStringAttribute("prebuildStep", &conf.prebuild);
-	configuration->QueryStringAttribute("postbuildStep", &conf.postbuild);
+		conf.artifact = description.name;
+	query_attribute(configuration, "prebuildStep", conf.prebuild);
+	query_attribute(configuration, "postbuildStep", conf.postbuild);
 
 	std::string buildArtefactType;
 	configuration->QueryStringAttribute("buildArtefactType", &buildArtefactType);
@@ -183,75 +319,37 @@ configuration_t project::configuration(const std::string& cconfiguration_id)
 			conf.build_folders.emplace_back();
 			configuration_t::build_folder& bf = conf.build_folders.back();
 
-			build_instr->QueryStringAttribute("resourcePath", &bf.path);
+			query_attribute(build_instr, "resourcePath", bf.path);
 
 			auto toolChain = build_instr->FirstChildElement("toolChain");
 			throw_if(!toolChain, "Unable to find toolChain node");
 
-			auto extract_option_list = [](TiXmlElement* option, std::vector<std::string>& list)
-			{
-				for(auto listOptionValue : elements_named(option, "listOptionValue"))
-				{
-					if(!listOptionValue->Attribute("value"))
-						continue;
-
-					const std::string value = listOptionValue->Attribute("value");
-					list.push_back(value);
-				}
-			};
-
-			auto extract_compiler_options = [&extract_option_list](TiXmlElement* tool, configuration_t::build_folder::compiler_t& compiler)
-			{
-				for(auto option : elements_named(tool, "option"))
-				{
-					std::string superClass;
-					option->QueryStringAttribute("superClass", &superClass);
-
-//					fprintf(stderr, "option: %s\n", superClass.c_str());
-
-					if(superClass.find("compiler.option.include.paths") != std::string::npos)
-						extract_option_list(option, compiler.includes);
-					else if(superClass.find("compiler.option.other.other") != std::string::npos)
-						option->QueryStringAttribute("value", &compiler.options);
-				}
-			};
-
-			auto extract_linker_options = [&extract_option_list](TiXmlElement* tool, configuration_t::build_folder::linker_t& linker)
-			{
-				for(auto option : elements_named(tool, "option"))
-				{
-					std::string superClass;
-					option->QueryStringAttribute("superClass", &superClass);
-
-//					fprintf(stderr, "option: %s\n", superClass.c_str());
-
-					if(superClass.find("link.option.libs") != std::string::npos)
-						extract_option_list(option, linker.libs);
-					else if(superClass.find("link.option.paths") != std::string::npos)
-						extract_option_list(option, linker.lib_paths);
-					else if(superClass.find("link.option.flags") != std::string::npos)
-						option->QueryStringAttribute("value", &linker.flags);
-				}
-			};
-
 			for(auto tool : elements_named(toolChain, "tool"))
 			{
 				std::string superClass;
 				tool->QueryStringAttribute("superClass", &superClass);
 
-//				fprintf(stderr, "tool: %s\n", superClass.c_str());
+				auto kind = classify_tool(superClass);
+				if(kind == tool_kind::unknown)
+					continue;
 
-				if(superClass.find("cpp.compiler") != std::string::npos)
-					extract_compiler_options(tool, bf.cpp.compiler);
-
-				else if(superClass.find("c.compiler") != std::string::npos)
-					extract_compiler_options(tool, bf.c.compiler);
+				for(auto element : elements_named(tool, "option"))
+				{
+					option_t option;
+					if(auto superClass = element->Attribute("superClass"))
+						option.kind = classify_option(superClass);
+					if(option.kind == option_kind::unknown)
+						continue;
+					option.has_value = element->QueryStringAttribute("value", &option.value) == TIXML_SUCCESS;
 
-				else if(superClass.find("cpp.linker") != std::string::npos)
-					extract_linker_options(tool, bf.cpp.linker);
+					for(auto listOptionValue : elements_named(element, "listOptionValue"))
+					{
+						if(auto value = listOptionValue->Attribute("value"))
+							option.list_values.emplace_back(value);
+					}
 
-				else if(superClass.find("c.linker") != std::string::npos)
-					extract_linker_options(tool, bf.c.linker);
+					apply_option(kind, option, bf);
+				}
 			}
 		}
 		else if(build_instr->ValueStr() == "fileInfo")
@@ -259,7 +357,7 @@ configuration_t project::configuration(const std::string& cconfiguration_id)
 			conf.build_files.emplace_back();
 			configuration_t::build_file& bf = conf.build_files.back();
 
-			build_instr->QueryStringAttribute("resourcePath", &bf.file);
+			query_attribute(build_instr, "resourcePath", bf.file);
 
 			for(auto tool : elements_named(build_instr, "tool"))
 			{
@@ -268,22 +366,38 @@ configuration_t project::configuration(const std::string& cconfiguration_id)
 
 				if(customBuildStep == "true")
 				{
-					tool->QueryStringAttribute("command", &bf.command);
+					query_attribute(tool, "command", bf.command);
 
 					if(auto inputType = tool->FirstChildElement("inputType"))
 					{
 						if(auto additionalInput = inputType->FirstChildElement("additionalInput"))
 						{
-							additionalInput->QueryStringAttribute("paths", &bf.inputs);
+							query_attribute(additionalInput, "paths", bf.inputs);
 						}
 					}
 					if(auto outputType = tool->FirstChildElement("outputType"))
 					{
-						outputType->QueryStringAttribute("outputNames", &bf.outputs);
+						query_attribute(outputType, "outputNames", bf.outputs);
 					}
 				}
 			}
 		}
+		else if(build_instr->ValueStr() == "sourceEntries")
+		{
+			for(auto entry : elements_named(build_instr, "entry"))
+			{
+				std::string kind;
+				entry->QueryStringAttribute("kind", &kind);
+				if(kind != "sourcePath")
+					continue;
+
+				std::string name;
+				std::string excluding;
+				entry->QueryStringAttribute("name", &name);
+				entry->QueryStringAttribute("excluding", &excluding);
+				conf.source_entries.push_back(resolve_source_entry(name, excluding));
+			}
+		}
 		else
 		{
 			throw std::runtime_error("Unknown build node: " + build_instr->ValueStr());
@@ -293,20 +407,12 @@ configuration_t project::configuration(const std::string& cconfiguration_id)
 	return conf;
 }
 
-TiXmlElement* project::cdtBuildSystem_configuration(const std::string& cconfiguration_id)
+TiXmlElement* project::cdtBuildSystem_configuration(const std::string& cconfiguration_id) const
 {
-	auto cdt_cconfiguration = cconfiguration(cconfiguration_id);
-	if(!cdt_cconfiguration)
+	auto it = cconfiguration_index.find(cconfiguration_id);
+	if(it == cconfiguration_index.end())
 		return nullptr;
-
-	for(auto storageModule = cdt_cconfiguration->FirstChildElement("storageModule"); storageModule; storageModule = storageModule->NextSiblingElement("storageModule"))
-	{
-		auto moduleId = storageModule->Attribute("moduleId");
-		if(moduleId && std::string(moduleId) == "cdtBuildSystem")
-			return storageModule->FirstChildElement("configuration");
-	}
-
-	return nullptr;
+	return it->second.buildsystem_configuration;
 }
 
 }
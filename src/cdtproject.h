@@ -10,11 +10,25 @@
 #include <string>
 #include <tinyxml.h>
 #include <vector>
+#include <map>
+#include <memory>
 #include "cdtconfiguration.h"
+#include "cprojectreader.h"
 
 namespace cdt
 {
 
+// Contents of a .project file.
+struct project_description
+{
+	std::string name;
+	std::string comment;
+	std::vector<std::string> references;
+	std::vector<std::string> natures;
+};
+
+project_description read_project_description(const std::string& project_file);
+
 /*
  * TODO Implement interface that reads different cdt / eclipse
  * project file formats and extracts enough information to
@@ -28,27 +42,50 @@ class project
 private:
 	std::string project_path;
 
-	TiXmlDocument project_doc;
-	TiXmlDocument cproject_doc;
+	// .project properties, read once on construction
+	project_description description;
+
+	std::vector<std::string> cconfiguration_ids;
+
+	// bytes of .project and .cproject read
+	std::size_t xml_size;
+
+	// configurations extracted from the .cproject
+	std::map<std::string, streamed_configuration> configurations;
+
+	// Fallback for documents the streaming reader rejects: the full DOM
+	// and an index of its cconfigurations by id. Only held while the
+	// configurations are extracted from it during construction.
+	std::unique_ptr<TiXmlDocument> cproject_doc;
+	struct cconfiguration_entry
+	{
+		TiXmlElement* cconfiguration;
+		TiXmlElement* buildsystem_configuration;
+	};
+	TiXmlElement* cdt_settings;
+	std::map<std::string, cconfiguration_entry> cconfiguration_index;
+
+	void load_cproject(const std::string& cproject_file);
+
+	TiXmlElement* settings() const;
+	TiXmlElement* cconfiguration(const std::string& id) const;
+	TiXmlElement* cdtBuildSystem_configuration(const std::string& cconfiguration_id) const;
+	configuration_t dom_configuration(const std::string& cconfiguration_id) const;
 public:
 	project(const std::string& project_base);
 
 	std::string path() const;
+	std::size_t descriptor_size() const;
 
 	// .project properties
-	std::string name();
-	std::string comment();
-	std::vector<std::string> referenced_projects();
-	std::vector<std::string> natures();
+	std::string name() const;
+	std::string comment() const;
+	std::vector<std::string> referenced_projects() const;
+	std::vector<std::string> natures() const;
 
 	// .cproject properties
-	TiXmlElement* settings();
-	std::vector<std::string> cconfigurations();
-	TiXmlElement* cconfiguration(const std::string& id);
-
-	configuration_t configuration(const std::string& cconfiguration_id);
-
-	TiXmlElement* cdtBuildSystem_configuration(const std::string& cconfiguration_id);
+	std::vector<std::string> cconfigurations() const;
+	const configuration_t& configuration(const std::string& cconfiguration_id) const;
 };
 
 }
@@ -0,0 +1,186 @@
+/*
+ * compiledb.cpp
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#include "compiledb.h"
+#include "cdtproject.h"
+#include "project.h"
+#include "sourcediscovery.h"
+#include "json.h"
+#include <stdexcept>
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+compile_commands_writer::compile_commands_writer(std::ostream& out)
+ : out(out), entries(0)
+{
+	out << '[';
+}
+
+void compile_commands_writer::add(const std::string& directory, const std::string& file, const std::vector<std::string>& arguments)
+{
+	out << (entries++ ? ",\n" : "\n") << "  {\"directory\": ";
+	write_json_string(out, directory);
+	out << ", \"file\": ";
+	write_json_string(out, file);
+	out << ", \"arguments\": [";
+	for(std::size_t i = 0; i < arguments.size(); ++i)
+	{
+		out << (i ? ", " : "");
+		write_json_string(out, arguments[i]);
+	}
+	out << "]}";
+}
+
+void compile_commands_writer::finish()
+{
+	out << (entries ? "\n]\n" : "]\n");
+}
+
+std::size_t compile_commands_writer::size() const
+{
+	return entries;
+}
+
+namespace
+{
+
+std::string absolute_path(const std::string& path)
+{
+	char resolved[PATH_MAX];
+	if(!realpath(path.c_str(), resolved))
+		throw std::runtime_error("Unable to resolve " + path);
+	return resolved;
+}
+
+std::string trim_slashes(const std::string& path)
+{
+	auto first = path.find_first_not_of('/');
+	if(first == std::string::npos)
+		return {};
+	return path.substr(first, path.find_last_not_of('/') + 1 - first);
+}
+
+/*
+ * Expands the CDT variables that locate paths. Relative paths are left
+ * alone; they are relative to the build folder the command runs in.
+ */
+std::string resolve_path(std::string path, const std::string& project_dir, const std::string& workspace_dir)
+{
+	if(path.size() > 1 && path.front() == '"' && path.back() == '"')
+		path = path.substr(1, path.size() - 2);
+
+	const std::string workspace_loc = "${workspace_loc:";
+	if(path.compare(0, workspace_loc.size(), workspace_loc) == 0)
+	{
+		auto close = path.find('}');
+		if(close != std::string::npos)
+			path = workspace_dir + '/' + trim_slashes(path.substr(workspace_loc.size(), close - workspace_loc.size())) + path.substr(close + 1);
+	}
+
+	const std::string project_loc = "${ProjDirPath}";
+	if(path.compare(0, project_loc.size(), project_loc) == 0)
+		path = project_dir + path.substr(project_loc.size());
+	return path;
+}
+
+std::vector<std::string> compiler_arguments(const char* compiler, const cdt::configuration_t::build_folder::compiler_t& settings,
+		const std::string& project_dir, const std::string& workspace_dir)
+{
+	std::vector<std::string> arguments{compiler};
+	for(auto flag : {&settings.optimization, &settings.debugging, &settings.standard})
+	{
+		if(!flag->empty())
+			arguments.push_back(*flag);
+	}
+	if(settings.pic)
+		arguments.push_back("-fPIC");
+	for(auto& define : settings.defines)
+		arguments.push_back("-D" + define);
+	for(auto& include : settings.includes)
+		arguments.push_back("-I" + resolve_path(include, project_dir, workspace_dir));
+
+	auto options = cmake::split(settings.options);
+	arguments.insert(arguments.end(), options.begin(), options.end());
+
+	// CDT's default flags already ask for compilation only
+	if(std::find(arguments.begin(), arguments.end(), "-c") == arguments.end())
+		arguments.push_back("-c");
+	return arguments;
+}
+
+}
+
+void write_compile_commands(const cdt::project& cdtproject, const std::string& configuration, const std::vector<std::string>& ignored,
+		unsigned int discovery_threads, compile_commands_writer& writer)
+{
+	const cdt::configuration_t* found = nullptr;
+	for(auto& id : cdtproject.cconfigurations())
+	{
+		auto& candidate = cdtproject.configuration(id);
+		if(configuration.empty() || candidate.name == configuration)
+		{
+			found = &candidate;
+			break;
+		}
+	}
+	if(!found)
+		throw std::runtime_error(configuration.empty() ? "No configurations" : "No configuration named " + configuration);
+	auto& conf = *found;
+
+	auto project_dir = absolute_path(cdtproject.path());
+	auto workspace_dir = project_dir.substr(0, project_dir.rfind('/'));
+	auto build_dir = project_dir + '/' + conf.name.str();
+
+	// Arguments before the source file, per folder and language.
+	struct folder_arguments
+	{
+		std::string path;
+		std::vector<std::string> c;
+		std::vector<std::string> cxx;
+	};
+	std::vector<folder_arguments> folders;
+	for(auto& bf : conf.build_folders)
+	{
+		folders.push_back({trim_slashes(bf.path),
+			compiler_arguments("gcc", bf.c.compiler, project_dir, workspace_dir),
+			compiler_arguments("g++", bf.cpp.compiler, project_dir, workspace_dir)});
+	}
+
+	source_filter filter;
+	for(auto& name : ignored)
+		filter.ignore_name(name);
+	cmake::add_source_entries(filter, conf);
+	auto sources = find_sources(cdtproject.path(), classify_source, discovery_threads, nullptr, &filter);
+
+	std::vector<std::string> arguments;
+	const folder_arguments* settings = nullptr;
+	std::string settings_for;
+	for(auto& source : sources)
+	{
+		// sources are sorted by folder, so look up each folder once
+		if(!settings || source.path != settings_for)
+		{
+			settings = nullptr;
+			settings_for = source.path;
+			for(auto& folder : folders)
+			{
+				bool contains = folder.path.empty() || source.path == folder.path ||
+					source.path.compare(0, folder.path.size() + 1, folder.path + '/') == 0;
+				if(contains && (!settings || folder.path.size() > settings->path.size()))
+					settings = &folder;
+			}
+			if(!settings)
+				continue;
+		}
+
+		auto file = project_dir + '/' + (source.path.empty() ? source.name : source.path + '/' + source.name);
+		arguments = source.lang == language::c ? settings->c : settings->cxx;
+		arguments.push_back(file);
+		writer.add(build_dir, file, arguments);
+	}
+}
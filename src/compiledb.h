@@ -0,0 +1,51 @@
+/*
+ * compiledb.h
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#ifndef COMPILEDB_H_
+#define COMPILEDB_H_
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstddef>
+
+namespace cdt
+{
+struct project;
+}
+
+/*
+ * JSON compilation database (compile_commands.json) written one entry
+ * at a time, so nothing is held per source file.
+ */
+class compile_commands_writer
+{
+public:
+	explicit compile_commands_writer(std::ostream& out);
+
+	void add(const std::string& directory, const std::string& file, const std::vector<std::string>& arguments);
+
+	// Closes the database; nothing can be added afterwards.
+	void finish();
+
+	std::size_t size() const;
+private:
+	std::ostream& out;
+	std::size_t entries;
+};
+
+/*
+ * Adds an entry for every source of the project, compiled with the
+ * settings of the configuration with the given name (the first
+ * configuration if empty) in the folder closest to the source. Sources
+ * outside the configuration's source entries, in its build folder or in
+ * directories named in ignored are left out. Commands run in the
+ * configuration's build folder, as they do in CDT.
+ */
+void write_compile_commands(const cdt::project& cdtproject, const std::string& configuration, const std::vector<std::string>& ignored,
+		unsigned int discovery_threads, compile_commands_writer& writer);
+
+#endif /* COMPILEDB_H_ */
@@ -0,0 +1,248 @@
+/*
+ * conversioncache.cpp
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#include "conversioncache.h"
+#include "hash.h"
+#include <sstream>
+#include <ctime>
+
+namespace
+{
+
+const char* manifest_header = "cdt2cmake-cache 1";
+
+// Filesystem timestamps come from a coarse clock; allow for it.
+const std::int64_t racy_margin = 1000000000;
+
+conversion_cache::file_state hash_file(const std::string& filename)
+{
+	conversion_cache::file_state state{stat_file(filename), 0};
+	std::string content;
+	if(state.status.exists && read_file(filename, content))
+		state.hash = fnv1a(content);
+	return state;
+}
+
+/*
+ * Unchanged if the stat matches, or if only the mtime moved and the
+ * content still hashes the same; in that case the stored mtime is
+ * refreshed so the next check is stat only again.
+ */
+bool unchanged(const std::string& filename, conversion_cache::file_state& recorded, bool& refreshed)
+{
+	auto status = stat_file(filename);
+	if(!status.exists)
+		return false;
+	if(status.mtime == recorded.status.mtime && status.size == recorded.status.size)
+		return true;
+	if(status.size != recorded.status.size)
+		return false;
+
+	auto current = hash_file(filename);
+	if(current.hash != recorded.hash)
+		return false;
+
+	recorded.status = current.status;
+	refreshed = true;
+	return true;
+}
+
+std::ostream& operator<<(std::ostream& os, const conversion_cache::file_state& state)
+{
+	return os << state.status.mtime << ' ' << state.status.size << ' ' << state.hash;
+}
+
+std::istream& operator>>(std::istream& is, conversion_cache::file_state& state)
+{
+	state.status.exists = true;
+	return is >> state.status.mtime >> state.status.size >> state.hash;
+}
+
+std::string rest_of_line(std::istream& is)
+{
+	is.ignore(1);
+	std::string s;
+	std::getline(is, s);
+	return s;
+}
+
+}
+
+conversion_cache::conversion_cache(const std::string& manifest)
+ : manifest(manifest), dirty(false)
+{
+}
+
+/*
+ * project <path>
+ * project_file <mtime> <size> <hash>
+ * cproject_file <mtime> <size> <hash>
+ * options <digest>
+ * sources <digest>
+ * listfile <mtime> <size> <hash>
+ * directory <mtime> <digest> <relative path>
+ * ...
+ * end
+ */
+void conversion_cache::load()
+{
+	std::string content;
+	if(!read_file(manifest, content))
+		return;
+
+	std::istringstream is(content);
+	std::string line;
+	if(!std::getline(is, line) || line != manifest_header)
+		return;
+
+	std::map<std::string, entry_t> loaded;
+	std::string key;
+	entry_t entry{};
+	std::string tag;
+	while(is >> tag)
+	{
+		if(tag == "project")
+		{
+			key = rest_of_line(is);
+			entry = entry_t{};
+		}
+		else if(tag == "project_file")
+			is >> entry.project;
+		else if(tag == "cproject_file")
+			is >> entry.cproject;
+		else if(tag == "options")
+			is >> entry.options_digest;
+		else if(tag == "sources")
+			is >> entry.sources_digest;
+		else if(tag == "listfile")
+			is >> entry.listfile;
+		else if(tag == "directory")
+		{
+			source_directory dir;
+			is >> dir.mtime >> dir.digest;
+			dir.path = rest_of_line(is);
+			entry.directories.push_back(dir);
+		}
+		else if(tag == "end")
+			loaded[key] = entry;
+		else
+			return;		// corrupt; start from scratch
+
+		if(!is)
+			return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	entries.swap(loaded);
+	dirty = false;
+}
+
+bool conversion_cache::save()
+{
+	std::ostringstream os;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if(!dirty)
+			return true;
+
+		os << manifest_header << '\n';
+		for(auto& e : entries)
+		{
+			auto& entry = e.second;
+			os << "project " << e.first << '\n';
+			os << "project_file " << entry.project << '\n';
+			os << "cproject_file " << entry.cproject << '\n';
+			os << "options " << entry.options_digest << '\n';
+			os << "sources " << entry.sources_digest << '\n';
+			os << "listfile " << entry.listfile << '\n';
+			for(auto& dir : entry.directories)
+				os << "directory " << dir.mtime << ' ' << dir.digest << ' ' << dir.path << '\n';
+			os << "end\n";
+		}
+		dirty = false;
+	}
+	return write_file_atomic(manifest, os.str());
+}
+
+bool conversion_cache::up_to_date(const std::string& project_path, std::uint64_t options_digest)
+{
+	entry_t entry;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto it = entries.find(project_path);
+		if(it == entries.end())
+			return false;
+		entry = it->second;
+	}
+
+	if(entry.options_digest != options_digest)
+		return false;
+
+	bool refreshed = false;
+	if(!unchanged(project_path + ".project", entry.project, refreshed))
+		return false;
+	if(!unchanged(project_path + ".cproject", entry.cproject, refreshed))
+		return false;
+	if(!unchanged(project_path + "CMakeLists.txt", entry.listfile, refreshed))
+		return false;
+
+	// Adding, removing or renaming an entry updates the directory mtime.
+	// Only when it moved is the directory read again, since writing the
+	// listfile or a manifest also touches the project folder.
+	for(auto& dir : entry.directories)
+	{
+		auto path = dir.path.empty() ? project_path : project_path + dir.path;
+		auto status = stat_file(path);
+		if(!status.exists)
+			return false;
+		if(status.mtime == dir.mtime)
+			continue;
+		if(directory_digest(path) != dir.digest)
+			return false;
+
+		dir.mtime = status.mtime;
+		refreshed = true;
+	}
+
+	if(refreshed)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		entries[project_path] = entry;
+		dirty = true;
+	}
+	return true;
+}
+
+conversion_cache::snapshot_t conversion_cache::snapshot(const std::string& project_path) const
+{
+	struct timespec now;
+	clock_gettime(CLOCK_REALTIME, &now);
+	return {static_cast<std::int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec, hash_file(project_path + ".project"), hash_file(project_path + ".cproject")};
+}
+
+void conversion_cache::update(const std::string& project_path, const snapshot_t& before, std::uint64_t options_digest, const cmake::result& res)
+{
+	entry_t entry;
+	entry.project = before.project;
+	entry.cproject = before.cproject;
+	entry.options_digest = options_digest;
+	entry.sources_digest = res.sources_digest;
+	entry.listfile = {stat_file(project_path + "CMakeLists.txt"), res.listfile_hash};
+	entry.directories = res.directories;
+
+	// A directory modified around the time it was walked may have changed
+	// after it was read; make sure the next check reads it again.
+	for(auto& dir : entry.directories)
+	{
+		if(dir.mtime + racy_margin >= before.time)
+			dir.mtime = -1;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	entries[project_path] = entry;
+	dirty = true;
+}
@@ -0,0 +1,78 @@
+/*
+ * conversioncache.h
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#ifndef CONVERSIONCACHE_H_
+#define CONVERSIONCACHE_H_
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <cstdint>
+#include "fileio.h"
+#include "project.h"
+
+/*
+ * Manifest of previous conversions, used to skip projects that have not
+ * changed since their listfile was last generated.
+ *
+ * For each project it records the .project / .cproject mtime, size and
+ * content hash, the options digest, a digest of the discovered sources
+ * with the mtime and entry digest of every directory walked, and the
+ * state of the generated CMakeLists.txt. Checking a project costs a stat
+ * per descriptor and per directory; files are only hashed, and
+ * directories only read, when a stat disagrees (e.g. a touched but
+ * unchanged descriptor).
+ *
+ * The manifest may hold any number of projects, so one file can serve a
+ * single project or a whole workspace. Methods are safe to call
+ * concurrently.
+ */
+class conversion_cache
+{
+public:
+	struct file_state
+	{
+		file_status status;
+		std::uint64_t hash;
+	};
+
+	// State of a project's descriptors, taken before converting it.
+	struct snapshot_t
+	{
+		std::int64_t time;
+		file_state project;
+		file_state cproject;
+	};
+
+	explicit conversion_cache(const std::string& manifest);
+
+	// A missing or unreadable manifest is treated as empty.
+	void load();
+	bool save();
+
+	bool up_to_date(const std::string& project_path, std::uint64_t options_digest);
+
+	snapshot_t snapshot(const std::string& project_path) const;
+	void update(const std::string& project_path, const snapshot_t& before, std::uint64_t options_digest, const cmake::result& res);
+private:
+	struct entry_t
+	{
+		file_state project;
+		file_state cproject;
+		std::uint64_t options_digest;
+		std::uint64_t sources_digest;
+		file_state listfile;
+		std::vector<source_directory> directories;
+	};
+
+	std::string manifest;
+	std::mutex mutex;
+	std::map<std::string, entry_t> entries;
+	bool dirty;
+};
+
+#endif /* CONVERSIONCACHE_H_ */
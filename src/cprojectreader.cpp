@@ -0,0 +1,304 @@
+/*
+ * cprojectreader.cpp
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#include "cprojectreader.h"
+#include "cdtoptions.h"
+#include "xmlstream.h"
+#include <stdexcept>
+#include <cstring>
+
+namespace cdt
+{
+
+namespace
+{
+
+bool query_attribute(xml_reader& xml, const char* name, istring& value)
+{
+	std::string text;
+	if(!xml.query_attribute(name, text))
+		return false;
+	value = text;
+	return true;
+}
+
+/*
+ * superClass ids are classified in place; only an id that contains
+ * entity references is decoded first.
+ */
+template <typename Kind>
+Kind classify_super_class(const xml_reader& xml, Kind (*classify)(const char*, std::size_t))
+{
+	text_view raw;
+	if(!xml.raw_attribute("superClass", raw))
+		return classify("", 0);
+	if(!std::memchr(raw.data, '&', raw.size))
+		return classify(raw.data, raw.size);
+
+	std::string superClass;
+	xml.query_attribute("superClass", superClass);
+	return classify(superClass.data(), superClass.size());
+}
+
+void read_tool(xml_reader& xml, tool_kind tool, configuration_t::build_folder& bf)
+{
+	while(xml.next() == xml_reader::start_element)
+	{
+		if(xml.name() != "option")
+		{
+			xml.skip();
+			continue;
+		}
+
+		option_t option;
+		option.kind = classify_super_class(xml, classify_option);
+		if(option.kind == option_kind::unknown)
+		{
+			xml.skip();
+			continue;
+		}
+		option.has_value = xml.query_attribute("value", option.value);
+
+		while(xml.next() == xml_reader::start_element)
+		{
+			std::string value;
+			if(xml.name() == "listOptionValue" && xml.query_attribute("value", value))
+				option.list_values.push_back(std::move(value));
+			xml.skip();
+		}
+
+		apply_option(tool, option, bf);
+	}
+}
+
+void read_folder(xml_reader& xml, configuration_t::build_folder& bf)
+{
+	query_attribute(xml, "resourcePath", bf.path);
+
+	bool have_toolchain = false;
+	while(xml.next() == xml_reader::start_element)
+	{
+		if(have_toolchain || xml.name() != "toolChain")
+		{
+			xml.skip();
+			continue;
+		}
+		have_toolchain = true;
+
+		while(xml.next() == xml_reader::start_element)
+		{
+			if(xml.name() != "tool")
+			{
+				xml.skip();
+				continue;
+			}
+
+			auto tool = classify_super_class(xml, classify_tool);
+			if(tool == tool_kind::unknown)
+				xml.skip();
+			else
+				read_tool(xml, tool, bf);
+		}
+	}
+
+	if(!have_toolchain)
+		throw std::runtime_error("Unable to find toolChain node");
+}
+
+void read_file(xml_reader& xml, configuration_t::build_file& bf)
+{
+	query_attribute(xml, "resourcePath", bf.file);
+
+	while(xml.next() == xml_reader::start_element)
+	{
+		if(xml.name() != "tool" || !xml.attribute_is("customBuildStep", "true"))
+		{
+			xml.skip();
+			continue;
+		}
+
+		query_attribute(xml, "command", bf.command);
+
+		bool have_input = false;
+		bool have_output = false;
+		while(xml.next() == xml_reader::start_element)
+		{
+			if(!have_input && xml.name() == "inputType")
+			{
+				have_input = true;
+
+				bool have_additional = false;
+				while(xml.next() == xml_reader::start_element)
+				{
+					if(!have_additional && xml.name() == "additionalInput")
+					{
+						have_additional = true;
+						query_attribute(xml, "paths", bf.inputs);
+					}
+					xml.skip();
+				}
+			}
+			else if(!have_output && xml.name() == "outputType")
+			{
+				have_output = true;
+				query_attribute(xml, "outputNames", bf.outputs);
+				xml.skip();
+			}
+			else
+			{
+				xml.skip();
+			}
+		}
+	}
+}
+
+void read_source_entries(xml_reader& xml, std::vector<configuration_t::source_entry>& entries)
+{
+	std::string name;
+	std::string excluding;
+	while(xml.next() == xml_reader::start_element)
+	{
+		if(xml.name() == "entry" && xml.attribute_is("kind", "sourcePath"))
+		{
+			name.clear();
+			excluding.clear();
+			xml.query_attribute("name", name);
+			xml.query_attribute("excluding", excluding);
+			entries.push_back(resolve_source_entry(name, excluding));
+		}
+		xml.skip();
+	}
+}
+
+void read_configuration(xml_reader& xml, const std::string& project_name, configuration_t& conf)
+{
+	query_attribute(xml, "name", conf.name);
+	query_attribute(xml, "artifactName", conf.artifact);
+	if(conf.artifact == "${ProjName}")
+		conf.artifact = project_name;
+	query_attribute(xml, "prebuildStep", conf.prebuild);
+	query_attribute(xml, "postbuildStep", conf.postbuild);
+
+	std::string buildArtefactType;
+	xml.query_attribute("buildArtefactType", buildArtefactType);
+	conf.type = resolve_artifact_type(buildArtefactType);
+
+	while(xml.next() == xml_reader::start_element)
+	{
+		if(xml.name() == "folderInfo")
+		{
+			conf.build_folders.emplace_back();
+			read_folder(xml, conf.build_folders.back());
+		}
+		else if(xml.name() == "fileInfo")
+		{
+			conf.build_files.emplace_back();
+			read_file(xml, conf.build_files.back());
+		}
+		else if(xml.name() == "sourceEntries")
+		{
+			read_source_entries(xml, conf.source_entries);
+		}
+		else
+		{
+			throw std::runtime_error("Unknown build node: " + xml.name().str());
+		}
+	}
+}
+
+void read_cconfiguration(xml_reader& xml, const std::string& project_name, streamed_configuration& streamed)
+{
+	auto level = xml.depth() - 1;
+	try
+	{
+		bool have_buildsystem = false;
+		bool have_configuration = false;
+		while(xml.next() == xml_reader::start_element)
+		{
+			if(have_buildsystem || xml.name() != "storageModule" || !xml.attribute_is("moduleId", "cdtBuildSystem"))
+			{
+				xml.skip();
+				continue;
+			}
+			have_buildsystem = true;
+
+			while(xml.next() == xml_reader::start_element)
+			{
+				if(!have_configuration && xml.name() == "configuration")
+				{
+					have_configuration = true;
+					read_configuration(xml, project_name, streamed.conf);
+				}
+				else
+				{
+					xml.skip();
+				}
+			}
+		}
+
+		if(!have_configuration)
+			throw std::runtime_error("Unable to read configuration");
+	}
+	catch(const xml_error&)
+	{
+		throw;
+	}
+	catch(const std::runtime_error& ex)
+	{
+		streamed.error = ex.what();
+		xml.skip_to(level);
+	}
+}
+
+void read_settings(xml_reader& xml, const std::string& project_name,
+		std::vector<std::string>& ids, std::map<std::string, streamed_configuration>& configurations)
+{
+	std::string id;
+	while(xml.next() == xml_reader::start_element)
+	{
+		if(xml.name() != "cconfiguration" || !xml.query_attribute("id", id) || configurations.count(id))
+		{
+			xml.skip();
+			continue;
+		}
+
+		ids.push_back(id);
+		read_cconfiguration(xml, project_name, configurations[id]);
+	}
+}
+
+}
+
+void read_cproject(const char* begin, const char* end, const std::string& cproject_file, const std::string& project_name,
+		std::vector<std::string>& ids, std::map<std::string, streamed_configuration>& configurations)
+{
+	xml_reader xml(begin, end);
+
+	if(xml.next() != xml_reader::start_element)
+		throw xml_error("Missing root node in " + cproject_file);
+	if(xml.name() != "cproject")
+		throw std::runtime_error("Unrecognised root node in" + cproject_file);
+
+	bool have_settings = false;
+	while(xml.next() == xml_reader::start_element)
+	{
+		if(!have_settings && xml.name() == "storageModule" && xml.attribute_is("moduleId", "org.eclipse.cdt.core.settings"))
+		{
+			have_settings = true;
+			read_settings(xml, project_name, ids, configurations);
+		}
+		else
+		{
+			xml.skip();
+		}
+	}
+
+	if(xml.next() != xml_reader::end_document)
+		throw xml_error("Content after root node in " + cproject_file);
+}
+
+}
@@ -0,0 +1,41 @@
+/*
+ * cprojectreader.h
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#ifndef CPROJECTREADER_H_
+#define CPROJECTREADER_H_
+#include <string>
+#include <vector>
+#include <map>
+#include "cdtconfiguration.h"
+
+namespace cdt
+{
+
+struct streamed_configuration
+{
+	configuration_t conf;
+
+	// Set when the configuration could not be read; reported when the
+	// configuration is requested, as the DOM reader would.
+	std::string error;
+};
+
+/*
+ * Extracts every cdtBuildSystem configuration from a .cproject document
+ * in one pass, skipping the subtrees that are not needed (externalSettings,
+ * scannerConfiguration, language settings, ...) without decoding them.
+ * ids receives the cconfiguration ids in document order.
+ *
+ * Throws xml_error when the document is not something the streaming
+ * reader handles, in which case the caller should fall back to the DOM.
+ */
+void read_cproject(const char* begin, const char* end, const std::string& cproject_file, const std::string& project_name,
+		std::vector<std::string>& ids, std::map<std::string, streamed_configuration>& configurations);
+
+}
+
+#endif /* CPROJECTREADER_H_ */
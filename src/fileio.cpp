@@ -0,0 +1,145 @@
+/*
+ * fileio.cpp
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#include "fileio.h"
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+
+file_status to_status(const struct stat& st)
+{
+	return {true, static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec, static_cast<std::uint64_t>(st.st_size)};
+}
+
+}
+
+file_status stat_file(const std::string& filename)
+{
+	struct stat st;
+	if(stat(filename.c_str(), &st) != 0)
+		return {false, 0, 0};
+	return to_status(st);
+}
+
+file_status stat_file(int dir_fd)
+{
+	struct stat st;
+	if(fstat(dir_fd, &st) != 0)
+		return {false, 0, 0};
+	return to_status(st);
+}
+
+bool read_file(const std::string& filename, std::string& content)
+{
+	std::ifstream file(filename, std::ios::in | std::ios::binary);
+	if(!file)
+		return false;
+
+	file.seekg(0, std::ios::end);
+	content.resize(file.tellg());
+	file.seekg(0, std::ios::beg);
+	file.read(&content[0], content.size());
+	return static_cast<bool>(file);
+}
+
+mapped_file::mapped_file()
+ : mapping(nullptr), length(0)
+{
+}
+
+mapped_file::~mapped_file()
+{
+	close();
+}
+
+bool mapped_file::open(const std::string& filename)
+{
+	close();
+
+	int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+	if(fd < 0)
+		return false;
+
+	struct stat st;
+	if(fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+	{
+		auto data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(data != MAP_FAILED)
+		{
+			::close(fd);
+			mapping = data;
+			length = st.st_size;
+			madvise(mapping, length, MADV_SEQUENTIAL);
+			return true;
+		}
+	}
+	::close(fd);
+
+	return read_file(filename, content);
+}
+
+void mapped_file::close()
+{
+	if(mapping)
+		munmap(mapping, length);
+	mapping = nullptr;
+	length = 0;
+	content.clear();
+}
+
+const char* mapped_file::begin() const
+{
+	return mapping ? static_cast<const char*>(mapping) : content.data();
+}
+
+const char* mapped_file::end() const
+{
+	return begin() + size();
+}
+
+std::size_t mapped_file::size() const
+{
+	return mapping ? length : content.size();
+}
+
+bool write_file_atomic(const std::string& filename, const std::string& content)
+{
+	auto temp = filename + ".tmp." + std::to_string(getpid());
+	{
+		std::ofstream file(temp, std::ios::out | std::ios::binary | std::ios::trunc);
+		file.write(content.data(), content.size());
+		file.close();
+		if(!file)
+		{
+			std::remove(temp.c_str());
+			return false;
+		}
+	}
+	if(std::rename(temp.c_str(), filename.c_str()) != 0)
+	{
+		std::remove(temp.c_str());
+		return false;
+	}
+	return true;
+}
+
+write_result write_file_if_changed(const std::string& filename, const std::string& content)
+{
+	{
+		mapped_file existing;
+		if(existing.open(filename) && existing.size() == content.size() && std::memcmp(existing.begin(), content.data(), content.size()) == 0)
+			return write_result::unchanged;
+	}
+	return write_file_atomic(filename, content) ? write_result::written : write_result::failed;
+}
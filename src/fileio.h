@@ -0,0 +1,67 @@
+/*
+ * fileio.h
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#ifndef FILEIO_H_
+#define FILEIO_H_
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+struct file_status
+{
+	bool exists;
+	std::int64_t mtime;		// nanoseconds since the epoch
+	std::uint64_t size;
+};
+
+file_status stat_file(const std::string& filename);
+file_status stat_file(int dir_fd);
+
+bool read_file(const std::string& filename, std::string& content);
+
+/*
+ * Read only view of a whole file. Regular files are mapped so that
+ * parsers can work on the bytes in place; anything that cannot be
+ * mapped is read into memory instead.
+ */
+class mapped_file
+{
+public:
+	mapped_file();
+	~mapped_file();
+
+	mapped_file(const mapped_file&) = delete;
+	mapped_file& operator=(const mapped_file&) = delete;
+
+	bool open(const std::string& filename);
+	void close();
+
+	const char* begin() const;
+	const char* end() const;
+	std::size_t size() const;
+private:
+	void* mapping;
+	std::size_t length;
+	std::string content;
+};
+
+// Writes content to a temporary file next to filename and renames it
+// into place, so readers see either the old or the new file.
+bool write_file_atomic(const std::string& filename, const std::string& content);
+
+enum class write_result
+{
+	unchanged,
+	written,
+	failed
+};
+
+// Like write_file_atomic but leaves the file, and its mtime, alone when
+// it already holds content.
+write_result write_file_if_changed(const std::string& filename, const std::string& content);
+
+#endif /* FILEIO_H_ */
@@ -0,0 +1,26 @@
+/*
+ * hash.cpp
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#include "hash.h"
+
+std::uint64_t fnv1a(const void* data, std::size_t size, std::uint64_t seed)
+{
+	auto bytes = static_cast<const unsigned char*>(data);
+	auto hash = seed;
+	for(std::size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+std::uint64_t fnv1a(const std::string& s, std::uint64_t seed)
+{
+	// include the terminator so ("ab", "c") and ("a", "bc") differ
+	return fnv1a(s.c_str(), s.size() + 1, seed);
+}
@@ -0,0 +1,23 @@
+/*
+ * hash.h
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#ifndef HASH_H_
+#define HASH_H_
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+/*
+ * 64 bit FNV-1a. Not cryptographic; used to detect changed content.
+ * Pass a previous result as seed to hash several pieces in sequence.
+ */
+const std::uint64_t fnv1a_seed = 14695981039346656037ULL;
+
+std::uint64_t fnv1a(const void* data, std::size_t size, std::uint64_t seed = fnv1a_seed);
+std::uint64_t fnv1a(const std::string& s, std::uint64_t seed = fnv1a_seed);
+
+#endif /* HASH_H_ */
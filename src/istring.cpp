@@ -0,0 +1,133 @@
+/*
+ * istring.cpp
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#include "istring.h"
+#include <unordered_set>
+#include <mutex>
+
+namespace
+{
+
+/*
+ * Sharded so that threads converting different projects rarely contend.
+ * Elements of an unordered_set keep their address when it rehashes,
+ * which is what makes handing out pointers to them safe.
+ */
+class string_pool
+{
+public:
+	const std::string* intern(const std::string& s)
+	{
+		auto hash = std::hash<std::string>()(s);
+		auto& shard = shards[hash % shard_count];
+
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		return &*shard.strings.insert(s).first;
+	}
+
+	std::size_t size()
+	{
+		std::size_t count = 0;
+		for(auto& shard : shards)
+		{
+			std::lock_guard<std::mutex> lock(shard.mutex);
+			count += shard.strings.size();
+		}
+		return count;
+	}
+private:
+	static const std::size_t shard_count = 16;
+
+	struct shard_t
+	{
+		std::mutex mutex;
+		std::unordered_set<std::string> strings;
+	};
+	shard_t shards[shard_count];
+};
+
+string_pool& pool()
+{
+	// never destroyed, so handles stay valid during static destruction
+	static auto instance = new string_pool;
+	return *instance;
+}
+
+const std::string* empty_string()
+{
+	static auto empty = pool().intern(std::string());
+	return empty;
+}
+
+}
+
+istring::istring()
+ : value(empty_string())
+{
+}
+
+istring::istring(const std::string& s)
+ : value(s.empty() ? empty_string() : pool().intern(s))
+{
+}
+
+istring::istring(const char* s)
+ : value(*s ? pool().intern(s) : empty_string())
+{
+}
+
+bool operator==(const istring& l, const std::string& r)
+{
+	return l.str() == r;
+}
+bool operator==(const std::string& l, const istring& r)
+{
+	return l == r.str();
+}
+bool operator==(const istring& l, const char* r)
+{
+	return l.str() == r;
+}
+bool operator!=(const istring& l, const std::string& r)
+{
+	return l.str() != r;
+}
+bool operator!=(const std::string& l, const istring& r)
+{
+	return l != r.str();
+}
+bool operator!=(const istring& l, const char* r)
+{
+	return l.str() != r;
+}
+
+std::string operator+(const std::string& l, const istring& r)
+{
+	return l + r.str();
+}
+std::string operator+(const istring& l, const std::string& r)
+{
+	return l.str() + r;
+}
+std::string operator+(const char* l, const istring& r)
+{
+	return l + r.str();
+}
+std::string operator+(const istring& l, const char* r)
+{
+	return l.str() + r;
+}
+
+std::ostream& operator<<(std::ostream& os, const istring& s)
+{
+	return os << s.str();
+}
+
+std::size_t interned_strings()
+{
+	return pool().size();
+}
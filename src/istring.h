@@ -0,0 +1,98 @@
+/*
+ * istring.h
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#ifndef ISTRING_H_
+#define ISTRING_H_
+#include <string>
+#include <ostream>
+#include <functional>
+#include <cstddef>
+
+/*
+ * Handle to an interned string. Every distinct value is stored once in a
+ * process wide pool and never freed, so handles are a pointer in size,
+ * cheap to copy, and equal exactly when they point at the same entry.
+ * Interning is safe from any thread.
+ */
+class istring
+{
+public:
+	istring();
+	istring(const std::string& s);
+	istring(const char* s);
+
+	const std::string& str() const
+	{
+		return *value;
+	}
+	operator const std::string&() const
+	{
+		return *value;
+	}
+	const char* c_str() const
+	{
+		return value->c_str();
+	}
+	bool empty() const
+	{
+		return value->empty();
+	}
+	std::size_t size() const
+	{
+		return value->size();
+	}
+
+	friend bool operator==(const istring& l, const istring& r)
+	{
+		return l.value == r.value;
+	}
+	friend bool operator!=(const istring& l, const istring& r)
+	{
+		return l.value != r.value;
+	}
+
+	// Orders by pointer, not by content; use str() for a lexical order.
+	friend bool operator<(const istring& l, const istring& r)
+	{
+		return std::less<const std::string*>()(l.value, r.value);
+	}
+
+	friend struct std::hash<istring>;
+private:
+	const std::string* value;
+};
+
+bool operator==(const istring& l, const std::string& r);
+bool operator==(const std::string& l, const istring& r);
+bool operator==(const istring& l, const char* r);
+bool operator!=(const istring& l, const std::string& r);
+bool operator!=(const std::string& l, const istring& r);
+bool operator!=(const istring& l, const char* r);
+
+std::string operator+(const std::string& l, const istring& r);
+std::string operator+(const istring& l, const std::string& r);
+std::string operator+(const char* l, const istring& r);
+std::string operator+(const istring& l, const char* r);
+
+std::ostream& operator<<(std::ostream& os, const istring& s);
+
+// Number of distinct strings interned so far.
+std::size_t interned_strings();
+
+namespace std
+{
+template <>
+struct hash<istring>
+{
+	std::size_t operator()(const istring& s) const
+	{
+		return std::hash<const std::string*>()(s.value);
+	}
+};
+}
+
+#endif /* ISTRING_H_ */
@@ -0,0 +1,24 @@
+/*
+ * json.cpp
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#include "json.h"
+#include <iomanip>
+
+void write_json_string(std::ostream& os, const std::string& s)
+{
+	os << '"';
+	for(unsigned char c : s)
+	{
+		if(c == '"' || c == '\\')
+			os << '\\' << c;
+		else if(c < 0x20)
+			os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+		else
+			os << c;
+	}
+	os << '"';
+}
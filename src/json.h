@@ -0,0 +1,16 @@
+/*
+ * json.h
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#ifndef JSON_H_
+#define JSON_H_
+#include <string>
+#include <ostream>
+
+// Writes s as a quoted JSON string.
+void write_json_string(std::ostream& os, const std::string& s);
+
+#endif /* JSON_H_ */
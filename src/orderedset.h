@@ -0,0 +1,144 @@
+/*
+ * orderedset.h
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#ifndef ORDEREDSET_H_
+#define ORDEREDSET_H_
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * Set that iterates in insertion order. Values live in a vector; once
+ * there are more than a handful of them an open addressing table of
+ * indices into the vector is kept alongside so that insert and contains
+ * stay O(1) rather than a scan of the list.
+ */
+template <typename T, typename Hash = std::hash<T> >
+class ordered_set
+{
+public:
+	typedef typename std::vector<T>::const_iterator const_iterator;
+	typedef const_iterator iterator;
+	typedef T value_type;
+
+	const_iterator begin() const
+	{
+		return items.begin();
+	}
+	const_iterator end() const
+	{
+		return items.end();
+	}
+	std::size_t size() const
+	{
+		return items.size();
+	}
+	bool empty() const
+	{
+		return items.empty();
+	}
+	const T& operator[](std::size_t i) const
+	{
+		return items[i];
+	}
+	const std::vector<T>& values() const
+	{
+		return items;
+	}
+
+	bool contains(const T& value) const
+	{
+		if(slots.empty())
+		{
+			for(auto& item : items)
+			{
+				if(item == value)
+					return true;
+			}
+			return false;
+		}
+		return slots[find_slot(value)] != 0;
+	}
+
+	// Appends value unless already present; returns whether it was added.
+	bool insert(T value)
+	{
+		if(slots.empty() && items.size() < linear_limit)
+		{
+			if(contains(value))
+				return false;
+			items.push_back(std::move(value));
+			return true;
+		}
+
+		if((items.size() + 1) * 2 > slots.size())
+			rehash(slots.empty() ? linear_limit * 4 : slots.size() * 2);
+
+		auto slot = find_slot(value);
+		if(slots[slot])
+			return false;
+		items.push_back(std::move(value));
+		slots[slot] = static_cast<std::uint32_t>(items.size());
+		return true;
+	}
+
+	template <typename It>
+	void insert(It first, It last)
+	{
+		for(; first != last; ++first)
+			insert(*first);
+	}
+
+	void clear()
+	{
+		items.clear();
+		slots.clear();
+	}
+
+	friend bool operator==(const ordered_set& l, const ordered_set& r)
+	{
+		return l.items == r.items;
+	}
+	friend bool operator!=(const ordered_set& l, const ordered_set& r)
+	{
+		return l.items != r.items;
+	}
+
+private:
+	static const std::size_t linear_limit = 8;
+
+	std::vector<T> items;
+
+	// 0 is empty, otherwise the index into items plus one.
+	// The size is zero or a power of two.
+	std::vector<std::uint32_t> slots;
+
+	std::size_t find_slot(const T& value) const
+	{
+		auto mask = slots.size() - 1;
+		auto slot = Hash()(value) & mask;
+		while(slots[slot] && !(items[slots[slot] - 1] == value))
+			slot = (slot + 1) & mask;
+		return slot;
+	}
+
+	void rehash(std::size_t size)
+	{
+		slots.assign(size, 0);
+		auto mask = size - 1;
+		for(std::size_t i = 0; i < items.size(); ++i)
+		{
+			auto slot = Hash()(items[i]) & mask;
+			while(slots[slot])
+				slot = (slot + 1) & mask;
+			slots[slot] = static_cast<std::uint32_t>(i + 1);
+		}
+	}
+};
+
+#endif /* ORDEREDSET_H_ */
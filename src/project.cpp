@@ -11,44 +11,95 @@
 #include <map>
 #include <vector>
 #include <algorithm>
-#include <fstream>
+#include <stdexcept>
 #include <sstream>
+#include <cctype>
+#include <cstring>
 #include <iterator>
+#include <iomanip>
+#include <climits>
+#include <cstdlib>
 #include "listfile.h"
+#include "hash.h"
+#include "fileio.h"
+#include "timings.h"
 
 namespace cmake
 {
 
-bool has_c_sources(const std::map<std::string, std::vector<std::string> >& sources)
+// Splits on whitespace.
+std::vector<std::string> split(const std::string& text)
 {
-	for(const auto& source_folder : sources)
+	auto is_space = [](char c){ return std::isspace(static_cast<unsigned char>(c)) != 0; };
+
+	std::vector<std::string> words;
+	auto it = text.begin();
+	while(true)
 	{
-		for(const auto& source : source_folder.second)
-		{
-			if(is_c_source_filename(source))
-				return true;
-		}
+		it = std::find_if_not(it, text.end(), is_space);
+		if(it == text.end())
+			break;
+		auto word_end = std::find_if(it, text.end(), is_space);
+		words.emplace_back(it, word_end);
+		it = word_end;
 	}
-	return false;
+	return words;
+}
+
+// Splits on whitespace, keeping the first occurrence of each token.
+void tokenize(const std::string& text, ordered_set<std::string>& tokens)
+{
+	auto words = split(text);
+	tokens.insert(std::make_move_iterator(words.begin()), std::make_move_iterator(words.end()));
 }
 
-bool has_cxx_sources(const std::map<std::string, std::vector<std::string> >& sources)
+// Quoted CMake argument.
+std::string quote(const std::string& value)
 {
-	for(const auto& source_folder : sources)
+	std::string quoted = "\"";
+	for(auto c : value)
 	{
-		for(const auto& source : source_folder.second)
-		{
-			if(is_cxx_source_filename(source))
-				return true;
-		}
+		if(c == '"' || c == '\\')
+			quoted += '\\';
+		quoted += c;
+	}
+	return quoted + '"';
+}
+
+// Joins differing values with separator; interned values compare by pointer.
+void join(const istring& source, istring& merged, const char* separator)
+{
+	if(source != merged)
+	{
+		if(merged.empty())
+			merged = source;
+		else
+			merged = merged + separator + source;
 	}
-	return false;
 }
 
-void merge(const cdt::configuration_t::build_folder::compiler_t& source, cdt::configuration_t::build_folder::compiler_t& merged)
+// Settings that only make sense when every configuration agrees on them.
+void keep_if_equal(const istring& source, istring& merged)
 {
-	for(auto inc : source.includes)
+	if(source != merged)
+		merged = {};
+}
+void keep_common(const ordered_set<istring>& source, ordered_set<istring>& merged)
+{
+	ordered_set<istring> common;
+	for(auto& value : merged)
 	{
+		if(source.contains(value))
+			common.insert(value);
+	}
+	merged = std::move(common);
+}
+
+void merge(const cdt::configuration_t::build_folder::compiler_t& source, cdt::configuration_t::build_folder::compiler_t& merged, bool first)
+{
+	for(const std::string& source_inc : source.includes)
+	{
+		auto inc = source_inc;
 		if(inc.find("\"${workspace_loc:/") == 0)
 		{
 			inc = inc.substr(18);
@@ -72,29 +123,34 @@ void merge(const cdt::configuration_t::build_folder::compiler_t& source, cdt::co
 				inc += '/';
 		}
 	
-		if(std::find(merged.includes.begin(), merged.includes.end(), inc) == merged.includes.end())
-		{
-			merged.includes.push_back(inc);
-		}
+		merged.includes.insert(inc);
 	}
 	
-	if(source.options != merged.options)
+	join(source.options, merged.options, " ");
+
+	if(first)
 	{
-		if(merged.options.empty())
-			merged.options = source.options;
-		else
-			merged.options += " " + source.options;
+		merged.defines = source.defines;
+		merged.optimization = source.optimization;
+		merged.debugging = source.debugging;
+		merged.standard = source.standard;
+		merged.pic = source.pic;
+	}
+	else
+	{
+		keep_common(source.defines, merged.defines);
+		keep_if_equal(source.optimization, merged.optimization);
+		keep_if_equal(source.debugging, merged.debugging);
+		keep_if_equal(source.standard, merged.standard);
+		merged.pic = merged.pic && source.pic;
 	}
 }
 void merge(const cdt::configuration_t::build_folder::linker_t& source, cdt::configuration_t::build_folder::linker_t& merged)
 {
-	for(auto& lib : source.libs)
-	{
-		if(std::find(merged.libs.begin(), merged.libs.end(), lib) == merged.libs.end())
-			merged.libs.push_back(lib);
-	}
-	for(auto lib : source.lib_paths)
+	merged.libs.insert(source.libs.begin(), source.libs.end());
+	for(const std::string& source_lib : source.lib_paths)
 	{
+		auto lib = source_lib;
 		if(lib.empty())
 			continue;
 		if(lib.find("\"${workspace_loc:/") == 0)
@@ -116,90 +172,176 @@ void merge(const cdt::configuration_t::build_folder::linker_t& source, cdt::conf
 		if(lib.empty())
 			continue;
 		
-		if(std::find(merged.lib_paths.begin(), merged.lib_paths.end(), lib) == merged.lib_paths.end())
-			merged.lib_paths.push_back(lib);
-	}
-	if(source.flags != merged.flags)
-	{
-		if(merged.flags.empty())
-			merged.flags = source.flags;
-		else
-			merged.flags += " " + source.flags;
+		merged.lib_paths.insert(lib);
 	}
+	join(source.flags, merged.flags, " ");
 }
 
-void merge(const cdt::configuration_t::build_folder& source, cdt::configuration_t::build_folder& merged)
+void merge(const cdt::configuration_t::build_folder& source, cdt::configuration_t::build_folder& merged, bool first)
 {
-	merge(source.c.compiler, merged.c.compiler);
+	merge(source.c.compiler, merged.c.compiler, first);
 	merge(source.c.linker, merged.c.linker);
-	merge(source.cpp.compiler, merged.cpp.compiler);
+	merge(source.cpp.compiler, merged.cpp.compiler, first);
 	merge(source.cpp.linker, merged.cpp.linker);
 }
 
 void merge(const cdt::configuration_t::build_file& source, cdt::configuration_t::build_file& merged)
 {
-	if(source.command != merged.command)
+	join(source.command, merged.command, " / ");
+	join(source.inputs, merged.inputs, " / ");
+	join(source.outputs, merged.outputs, " / ");
+}
+
+std::uint64_t digest(const options& opts)
+{
+	// bump when the generated output changes for the same input
+	const std::string format_version = "3";
+	auto hash = fnv1a(format_version);
+	if(opts.build_settings)
+		hash = fnv1a(std::string("build settings"), hash);
+	hash = fnv1a(std::string(opts.precompiled_headers ? "pch" : ""), hash);
+	if(opts.unity_build)
+		hash = fnv1a("unity " + std::to_string(opts.unity_batch_size), hash);
+	if(!opts.pools.empty())
 	{
-		if(merged.command.empty())
-			merged.command = source.command;
-		else
-			merged.command += " / " + source.command;
+		auto& pools = opts.pools;
+		hash = fnv1a("pools " + std::to_string(pools.compile) + ' ' + std::to_string(pools.link_executable) + ' ' +
+			std::to_string(pools.link_static) + ' ' + std::to_string(pools.link_shared), hash);
 	}
-	if(source.inputs != merged.inputs)
+	for(auto& name : opts.ignored)
+		hash = fnv1a("ignore " + name, hash);
+	if(!opts.compiler_launcher.empty())
+		hash = fnv1a("launcher " + opts.compiler_launcher, hash);
+	return hash;
+}
+
+/*
+ * Removes "-include header" and "-includeheader" from compiler flags,
+ * collecting the headers. The header is located relative to the
+ * project folder, as CDT compiles from a configuration folder below it.
+ */
+std::string strip_forced_includes(const std::string& flags, ordered_set<std::string>& headers)
+{
+	auto words = split(flags);
+	std::string rest;
+	for(std::size_t i = 0; i < words.size(); ++i)
 	{
-		if(merged.inputs.empty())
-			merged.inputs = source.inputs;
+		std::string header;
+		if(words[i] == "-include" && i + 1 < words.size())
+			header = words[++i];
+		// -include<path>, but not other flags such as -include-pch
+		else if(words[i].size() > 8 && words[i].compare(0, 8, "-include") == 0 && words[i][8] != '-')
+			header = words[i].substr(8);
 		else
-			merged.inputs += " / " + source.inputs;
+		{
+			rest += words[i] + ' ';
+			continue;
+		}
+
+		if(header.size() > 1 && header.front() == '"' && header.back() == '"')
+			header = header.substr(1, header.size() - 2);
+		if(header.find("${workspace_loc:/") == 0 && header.back() == '}')
+			header = "${CMAKE_SOURCE_DIR}/" + header.substr(17, header.size() - 18);
+		else if(header.find("${ProjDirPath}/") == 0)
+			header = header.substr(15);
+		else if(header.find("../") == 0)
+			header = header.substr(3);
+		headers.insert(header);
+	}
+	return rest;
+}
+
+// Headers commonly included first by every source of a project.
+const char* const tree_header_names[] = {"pch.h", "stdafx.h", "precompiled.h", "pch.hpp"};
+
+std::string find_tree_header(const project_model& model)
+{
+	std::vector<std::string> folders{std::string()};
+	for(auto& folder : model.sources)
+	{
+		if(!folder.first.empty())
+			folders.push_back(folder.first + "/");
 	}
-	if(source.outputs != merged.outputs)
+
+	for(auto& folder : folders)
 	{
-		if(merged.outputs.empty())
-			merged.outputs = source.outputs;
-		else
-			merged.outputs += " / " + source.outputs;
+		for(auto name : tree_header_names)
+		{
+			if(stat_file(model.path + folder + name).exists)
+				return folder + name;
+		}
 	}
+	return {};
 }
 
-// one step, take cdt files and write cmakelists.
-void generate(cdt::project& cdtproject, bool write_files)
+void add_source_entries(source_filter& filter, const cdt::configuration_t& conf)
+{
+	std::vector<source_filter::entry> entries;
+	for(auto& source_entry : conf.source_entries)
+	{
+		entries.push_back({source_entry.path, {}});
+		for(auto& excluded : source_entry.excluding)
+			entries.back().excluding.push_back(excluded);
+	}
+	filter.add_configuration(entries);
+
+	// CDT builds each configuration in a folder named after it
+	filter.ignore_folder(conf.name);
+}
+
+void discover(const cdt::project& cdtproject, const options& opts, project_model& model, result& res)
 {
-	auto project_name = cdtproject.name();
-	auto project_path = cdtproject.path();
+	model.name = cdtproject.name();
+	model.path = cdtproject.path();
 
-	std::map<std::string, std::vector<std::string> > sources;
+	model.filter = source_filter();
+	for(auto& name : opts.ignored)
+		model.filter.ignore_name(name);
+	for(auto& id : cdtproject.cconfigurations())
+		add_source_entries(model.filter, cdtproject.configuration(id));
+
+	auto source_files = find_sources(model.path, classify_source, opts.discovery_threads, opts.record_directories ? &res.directories : nullptr,
+		&model.filter);
+	res.sources_digest = sources_digest(source_files);
+	for(auto& source : source_files)
 	{
-		auto source_files = find_sources(cdtproject.path(), is_source_filename);
-		for(const auto& source : source_files)
-			sources[source.path].push_back(source.name);
+		++model.language_sources[static_cast<int>(source.lang)];
+		model.sources[source.path].push_back(std::move(source));
 	}
 
-	bool lang_c = has_c_sources(sources);
-	bool lang_cxx = has_cxx_sources(sources);
+	model.build_settings = opts.build_settings;
+	model.precompiled_headers = opts.precompiled_headers;
+	if(model.precompiled_headers)
+		model.tree_header = find_tree_header(model);
+	model.unity_build = opts.unity_build;
+	model.unity_batch_size = opts.unity_batch_size;
+	model.pools = opts.pools;
+
+	model.compiler_launcher = opts.compiler_launcher;
+	if(!model.compiler_launcher.empty())
+	{
+		char resolved[PATH_MAX];
+		if(realpath(model.path.c_str(), resolved))
+		{
+			model.workspace_path = resolved;
+			model.workspace_path.erase(model.workspace_path.rfind('/'));
+		}
+	}
+}
 
-	std::map<std::string, cdt::configuration_t> artifact_configurations;
+void merge(const cdt::project& cdtproject, project_model& model)
+{
+	auto& artifact_configurations = model.artifacts;
 	
 	auto confs = cdtproject.cconfigurations();
 	for(const auto& conf_name : confs)
 	{
-		auto c = cdtproject.configuration(conf_name);
+		const auto& c = cdtproject.configuration(conf_name);
 		cdt::configuration_t& a = artifact_configurations[c.artifact + to_string(c.type)];
 		a.name = c.artifact + to_string(c.type);
 		a.artifact = c.artifact;
-		if(a.prebuild != c.prebuild)
-		{
-			if(a.prebuild.empty())
-				a.prebuild = c.prebuild;
-			else
-				a.prebuild += " / " + c.prebuild;
-		}
-		if(a.postbuild != c.postbuild)
-		{
-			if(a.postbuild.empty())
-				a.postbuild = c.postbuild;
-			else
-				a.postbuild += " / " + c.postbuild;
-		}
+		join(c.prebuild, a.prebuild, " / ");
+		join(c.postbuild, a.postbuild, " / ");
 		a.type = c.type;
 
 		for(auto& bf : c.build_folders)
@@ -211,7 +353,8 @@ void generate(cdt::project& cdtproject, bool write_files)
 					merged_bf = &abf;
 			}
 			
-			if(!merged_bf)
+			bool first = !merged_bf;
+			if(first)
 			{
 				cdt::configuration_t::build_folder nbf;
 				nbf.path = bf.path;
@@ -219,7 +362,7 @@ void generate(cdt::project& cdtproject, bool write_files)
 				a.build_folders.push_back(nbf);
 				merged_bf = &a.build_folders.back();
 			}
-			merge(bf, *merged_bf);
+			merge(bf, *merged_bf, first);
 		}
 		for(auto& bf : c.build_files)
 		{
@@ -240,50 +383,589 @@ void generate(cdt::project& cdtproject, bool write_files)
 			}
 		}
 	}
+}
+
+// Required CMake version as major * 10000 + minor * 100 + patch.
+void require(int& minimum_version, int version)
+{
+	minimum_version = std::max(minimum_version, version);
+}
+
+void emit_sources(std::ostream& master, const project_model& model)
+{
+	for(const auto& source_folder : model.sources)
+	{
+		for(const auto& source : source_folder.second)
+		{
+			master << (source_folder.second.size() > 3 ? "\n   " : " ") << (source_folder.first.empty() ? std::string{} : source_folder.first + "/") << source.name;
+		}
+		master << "\n";
+	}
+}
+
+void emit_unity_build(std::ostream& master, const std::string& target, const project_model& model, int& minimum_version)
+{
+	master << "set_target_properties(" << target << " PROPERTIES UNITY_BUILD ON";
+	if(model.unity_batch_size)
+	{
+		master << " UNITY_BUILD_BATCH_SIZE " << model.unity_batch_size;
+		require(minimum_version, 31600);
+	}
+	else
+	{
+		master << " UNITY_BUILD_MODE GROUP";
+		require(minimum_version, 31800);
+	}
+	master << ")\n";
+}
+
+/*
+ * Compiles through the launcher when it is installed, unless the build
+ * already chose one. CMAKE_<LANG>_COMPILER_LAUNCHER needs CMake 3.4.
+ */
+void emit_compiler_launcher(std::ostream& master, const std::string& launcher)
+{
+	auto name = launcher.substr(launcher.rfind('/') + 1);
+	std::string variable;
+	for(auto c : name)
+		variable += std::isalnum(static_cast<unsigned char>(c)) ? std::toupper(static_cast<unsigned char>(c)) : '_';
+	variable += "_PROGRAM";
+
+	master << "find_program(" << variable << ' ' << quote(launcher) << ")\n";
+	master << "if(" << variable << " AND NOT CMAKE_CXX_COMPILER_LAUNCHER)\n";
+	master << "   set(CMAKE_C_COMPILER_LAUNCHER \"${" << variable << "}\")\n";
+	master << "   set(CMAKE_CXX_COMPILER_LAUNCHER \"${" << variable << "}\")\n";
+	master << "endif()\n\n";
+}
+
+// Rewrites a path in the workspace, alone or after -I and the like, to
+// be relative to ${CMAKE_SOURCE_DIR}.
+std::string relocate(const std::string& flag, const std::string& workspace_path)
+{
+	if(workspace_path.empty())
+		return flag;
+
+	for(auto prefix : {"", "-I", "-isystem", "-iquote", "-include"})
+	{
+		auto length = std::strlen(prefix);
+		if(flag.compare(0, length, prefix) != 0)
+			continue;
+		if(flag.compare(length, workspace_path.size(), workspace_path) == 0 &&
+				(flag.size() == length + workspace_path.size() || flag[length + workspace_path.size()] == '/'))
+			return prefix + ("${CMAKE_SOURCE_DIR}" + flag.substr(length + workspace_path.size()));
+	}
+	return flag;
+}
+
+// -W and -f flags other than -Wl, -Wa and -Wp, which pass options on.
+bool is_sortable_flag(const std::string& flag)
+{
+	if(flag.size() < 3 || flag[0] != '-' || (flag[1] != 'W' && flag[1] != 'f'))
+		return false;
+	return !(flag[1] == 'W' && flag[3] == ',' && (flag[2] == 'l' || flag[2] == 'a' || flag[2] == 'p'));
+}
+
+// What a sortable flag sets: -Wno-x and -Wx=1 both set -Wx.
+std::string flag_key(const std::string& flag)
+{
+	auto key = flag.substr(1);
+	if(key.compare(1, 3, "no-") == 0)
+		key.erase(1, 3);
+	return key.substr(0, key.find('='));
+}
+
+/*
+ * Puts the -W and -f flags in a stable order, so targets whose flags
+ * differ only in order compile with the same command line and share
+ * compiler cache entries. Flags setting the same option keep their
+ * relative order, so the last one still wins; other flags keep their
+ * place. Paths in the workspace are made relative to ${CMAKE_SOURCE_DIR}.
+ */
+std::vector<std::string> normalize_flags(const ordered_set<std::string>& flags, const std::string& workspace_path)
+{
+	std::vector<std::string> normalized;
+	std::vector<std::string> sortable;
+	for(auto& flag : flags)
+	{
+		normalized.push_back(relocate(flag, workspace_path));
+		if(is_sortable_flag(flag))
+			sortable.push_back(flag);
+	}
+
+	std::stable_sort(sortable.begin(), sortable.end(), [](const std::string& l, const std::string& r)
+	{
+		return flag_key(l) < flag_key(r);
+	});
+	auto next = sortable.begin();
+	for(auto& flag : normalized)
+	{
+		if(is_sortable_flag(flag))
+			flag = *next++;
+	}
+	return normalized;
+}
+
+// What a build folder passes to the compiler, as emitted for a target.
+struct compile_settings
+{
+	std::vector<std::string> includes;
+	ordered_set<istring> defines;
+	std::vector<std::string> options;
+
+	// with precompiled_headers, by the language they are used for
+	ordered_set<std::string> c_headers;
+	ordered_set<std::string> cxx_headers;
+	bool pic = false;
+};
+
+compile_settings resolve_compile_settings(const cdt::configuration_t::build_folder& bf, const project_model& model)
+{
+	auto lang_c = model.has_sources(language::c);
+	auto lang_cxx = model.has_sources(language::cxx);
+	compile_settings settings;
+
+	if(lang_cxx)
+	{
+		for(auto& inc : bf.cpp.compiler.includes)
+			settings.includes.push_back(relocate(inc, model.workspace_path));
+	}
+	if(lang_c)
+	{
+		for(auto& inc : bf.c.compiler.includes)
+			settings.includes.push_back(relocate(inc, model.workspace_path));
+	}
+
+	ordered_set<std::string> options;
+	if(model.build_settings)
+	{
+		if(lang_cxx)
+			settings.defines.insert(bf.cpp.compiler.defines.begin(), bf.cpp.compiler.defines.end());
+		if(lang_c)
+			settings.defines.insert(bf.c.compiler.defines.begin(), bf.c.compiler.defines.end());
+
+		for(auto compiler : {lang_cxx ? &bf.cpp.compiler : nullptr, lang_c ? &bf.c.compiler : nullptr})
+		{
+			if(!compiler)
+				continue;
+			tokenize(compiler->optimization, options);
+			tokenize(compiler->debugging, options);
+		}
+		// one language standard; the c++ one when there are c++ sources
+		tokenize(lang_cxx ? bf.cpp.compiler.standard : bf.c.compiler.standard, options);
+
+		settings.pic = (lang_cxx && bf.cpp.compiler.pic) || (lang_c && bf.c.compiler.pic);
+	}
+	auto compiler_options = [&](const cdt::configuration_t::build_folder::compiler_t& compiler, ordered_set<std::string>& headers)
+	{
+		if(model.precompiled_headers)
+			tokenize(strip_forced_includes(compiler.options, headers), options);
+		else
+			tokenize(compiler.options, options);
+	};
+	if(lang_cxx)
+		compiler_options(bf.cpp.compiler, settings.cxx_headers);
+	if(lang_c)
+		compiler_options(bf.c.compiler, settings.c_headers);
+	if(model.compiler_launcher.empty())
+		settings.options.assign(options.begin(), options.end());
+	else
+		settings.options = normalize_flags(options, model.workspace_path);
+
+	// the header found in the tree is only used for c++ sources
+	if(model.precompiled_headers && settings.cxx_headers.empty() && lang_cxx && !model.tree_header.empty())
+		settings.cxx_headers.insert(model.tree_header);
+	return settings;
+}
+
+// What a build folder passes to the linker.
+struct link_settings
+{
+	std::vector<std::string> flags;
+	std::vector<std::string> lib_paths;
+	std::vector<std::string> libs;
+};
+
+link_settings resolve_link_settings(const cdt::configuration_t::build_folder& bf, const project_model& model)
+{
+	// use c++ linker settings when there are c++ sources.
+	auto& linker = model.has_sources(language::cxx) ? bf.cpp.linker : bf.c.linker;
+	link_settings settings;
+
+	ordered_set<std::string> flags;
+	tokenize(linker.flags, flags);
+	settings.flags.assign(flags.begin(), flags.end());
+	settings.lib_paths.assign(linker.lib_paths.begin(), linker.lib_paths.end());
+	settings.libs.assign(linker.libs.begin(), linker.libs.end());
+	return settings;
+}
+
+void emit_interface_list(std::ostream& master, const char* command, const std::string& target, const std::vector<std::string>& values, bool quoted)
+{
+	if(values.empty())
+		return;
+	master << command << '(' << target << " INTERFACE";
+	for(auto& value : values)
+		master << (values.size() > 3 ? "\n   " : " ") << (quoted ? quote(value) : value);
+	master << ")\n";
+}
+
+/*
+ * The INTERFACE library carrying the settings. Rendered with an empty
+ * target it is the text settings blocks are compared by.
+ */
+std::string compile_interface(const std::string& target, const compile_settings& settings)
+{
+	std::ostringstream definition;
+	definition << "add_library(" << target << " INTERFACE)\n";
+	emit_interface_list(definition, "target_include_directories", target, settings.includes, true);
+	emit_interface_list(definition, "target_compile_definitions", target, std::vector<std::string>(settings.defines.begin(), settings.defines.end()), true);
+	emit_interface_list(definition, "target_compile_options", target, settings.options, true);
+	return definition.str();
+}
+
+// target_link_options and target_link_directories need CMake 3.13.
+std::string link_interface(const std::string& target, const link_settings& settings)
+{
+	std::ostringstream definition;
+	definition << "add_library(" << target << " INTERFACE)\n";
+	emit_interface_list(definition, "target_link_options", target, settings.flags, true);
+	emit_interface_list(definition, "target_link_directories", target, settings.lib_paths, true);
+	emit_interface_list(definition, "target_link_libraries", target, settings.libs, false);
+	return definition.str();
+}
+
+std::uint64_t compile_digest(const compile_settings& settings)
+{
+	if(settings.includes.empty() && settings.defines.empty() && settings.options.empty())
+		return 0;
+	return fnv1a(compile_interface({}, settings));
+}
 
-	std::streambuf* buf;
-	std::ofstream of;
-	if(write_files)
+std::uint64_t link_digest(const link_settings& settings)
+{
+	if(settings.flags.empty() && settings.lib_paths.empty() && settings.libs.empty())
+		return 0;
+	return fnv1a(link_interface({}, settings));
+}
+
+// The INTERFACE library that provides a settings block, or null.
+const std::string* shared_block(const project_model& model, std::uint64_t digest)
+{
+	if(!digest)
+		return nullptr;
+	auto it = model.shared_blocks.find(digest);
+	return it == model.shared_blocks.end() ? nullptr : &it->second;
+}
+
+// Settings of the top level build folder that apply when compiling.
+void emit_compile_settings(std::ostream& master, const std::string& target, const cdt::configuration_t::build_folder& bf,
+		const project_model& model, bool position_independent, bool object_library, int& minimum_version)
+{
+	auto settings = resolve_compile_settings(bf, model);
+
+	if(auto shared = shared_block(model, compile_digest(settings)))
 	{
-		of.open(project_path + "/CMakeLists.txt");
-		buf = of.rdbuf();
+		// PRIVATE, so the settings do not reach targets linking this one
+		master << "target_link_libraries(" << target << " PRIVATE " << *shared << ")\n\n";
+		// OBJECT libraries can only link from 3.12
+		require(minimum_version, object_library ? 31200 : 20812);
 	}
 	else
 	{
-		buf = std::cout.rdbuf();
+		auto lang_c = model.has_sources(language::c);
+		auto lang_cxx = model.has_sources(language::cxx);
+
+		if(!bf.cpp.compiler.includes.empty() || !bf.c.compiler.includes.empty())
+		{
+			//master << "set_property (TARGET " << target << " PROPERTY INCLUDE_DIRECTORIES";
+			master << "INCLUDE_DIRECTORIES(";
+			if(lang_cxx)
+			{
+				for(auto& inc : bf.cpp.compiler.includes)
+					master << (bf.cpp.compiler.includes.size() > 3 ? "\n   " : " ") << '"' << relocate(inc, model.workspace_path) << '"';
+			}
+			if(lang_c)
+			{
+				for(auto& inc : bf.c.compiler.includes)
+					master << (bf.c.compiler.includes.size() > 3 ? "\n   " : " ") << '"' << relocate(inc, model.workspace_path) << '"';
+			}
+			master << ")\n\n";
+		}
+
+		auto& defines = settings.defines;
+		if(!defines.empty())
+		{
+			master << "set_property(TARGET " << target << " APPEND PROPERTY COMPILE_DEFINITIONS";
+			for(auto& define : defines)
+				master << (defines.size() > 3 ? "\n   " : " ") << quote(define);
+			master << ")\n\n";
+		}
+
+		if(!settings.options.empty())
+		{
+			master << "set_target_properties(" << target << " PROPERTIES COMPILE_FLAGS \"";
+			for(auto& o : settings.options)
+				master << o << ' ';
+			master << "\")\n\n";
+		}
+	}
+	
+	// target_precompile_headers applies to every language, so in a
+	// mixed project each header is limited to its own; paths within
+	// generator expressions are not made absolute by CMake
+	std::vector<std::string> headers;
+	bool mixed = model.has_sources(language::c) && model.has_sources(language::cxx);
+	auto add_headers = [&](const ordered_set<std::string>& language_headers, const char* lang)
+	{
+		for(auto& header : language_headers)
+		{
+			auto path = relocate(header, model.workspace_path);
+			if(!mixed)
+				headers.push_back(path);
+			else if(path.front() == '$' || path.front() == '/')
+				headers.push_back(std::string("$<$<COMPILE_LANGUAGE:") + lang + ">:" + path + ">");
+			else
+				headers.push_back(std::string("$<$<COMPILE_LANGUAGE:") + lang + ">:${CMAKE_CURRENT_SOURCE_DIR}/" + path + ">");
+		}
+	};
+	add_headers(settings.cxx_headers, "CXX");
+	add_headers(settings.c_headers, "C");
+	if(!headers.empty())
+	{
+		master << "target_precompile_headers(" << target << " PRIVATE";
+		for(auto& header : headers)
+			master << (headers.size() > 3 ? "\n   " : " ") << quote(header);
+		master << ")\n\n";
+		require(minimum_version, 31600);
 	}
-	std::ostream master(buf);
 	
-	master << "cmake_minimum_required (VERSION 2.8)\n";
-	master << "project (" << project_name << ")\n";
+	if(settings.pic && !position_independent)
+		master << "set_target_properties(" << target << " PROPERTIES POSITION_INDEPENDENT_CODE ON)\n\n";
+}
+
+void emit_link_settings(std::ostream& master, const std::string& target, const cdt::configuration_t::build_folder& bf, const project_model& model,
+		int& minimum_version)
+{
+	auto settings = resolve_link_settings(bf, model);
+
+	if(auto shared = shared_block(model, link_digest(settings)))
+	{
+		master << "target_link_libraries(" << target << " PRIVATE " << *shared << ")\n\n";
+		require(minimum_version, 20812);
+		return;
+	}
+	// a target links with keywords throughout or not at all
+	bool keywords = shared_block(model, compile_digest(resolve_compile_settings(bf, model))) != nullptr;
+
+	if(!settings.flags.empty())
+	{
+		master << "set_target_properties(" << target << " PROPERTIES LINK_FLAGS \"";
+		for(auto& o : settings.flags)
+			master << o << ' ';
+		master << "\")\n";
+	}
+
+	auto& lib_paths = settings.lib_paths;
+	if(!lib_paths.empty())
+	{
+		master << "link_directories (";
+		for(auto& path : lib_paths)
+			master << (lib_paths.size() > 3 ? "\n   " : " ") << path;
+		master << ")\n";
+	}
+
+	auto& libs = settings.libs;
+	if(!libs.empty())
+	{
+		master << "target_link_libraries (" << target << (keywords ? " PRIVATE" : "");
+		for(auto& lib : libs)
+			master << (libs.size() > 3 ? "\n   " : " ") << lib;
+		master << ")\n\n";
+	}
+}
+
+/*
+ * Other projects of the same build may define the pools already, and
+ * Ninja rejects a pool defined twice.
+ */
+void emit_job_pools(std::ostream& master, const job_pools& pools)
+{
+	const std::pair<const char*, unsigned int> sizes[] =
+	{
+		{"compile", pools.compile},
+		{"link_executable", pools.link_executable},
+		{"link_static", pools.link_static},
+		{"link_shared", pools.link_shared}
+	};
+
+	master << "get_property(defined_job_pools GLOBAL PROPERTY JOB_POOLS)\n";
+	for(auto& pool : sizes)
+	{
+		if(!pool.second)
+			continue;
+		master << "if(NOT defined_job_pools MATCHES \"(^|;)" << pool.first << "=\")\n";
+		master << "   set_property(GLOBAL APPEND PROPERTY JOB_POOLS " << pool.first << '=' << pool.second << ")\n";
+		master << "endif()\n";
+	}
 	master << "\n";
+}
 
-	for(auto& ac : artifact_configurations)
+void emit_target_job_pools(std::ostream& master, const std::string& target, const job_pools& pools, bool compiles, const cdt::configuration_t::Type* type)
+{
+	std::string properties;
+	if(compiles && pools.compile)
+		properties += " JOB_POOL_COMPILE compile";
+	if(type)
 	{
-		auto& c = ac.second;
-		
-		switch(c.type)
+		switch(*type)
 		{
 			case cdt::configuration_t::Type::Executable:
-				master << "add_executable (" << c.artifact;
+				if(pools.link_executable)
+					properties += " JOB_POOL_LINK link_executable";
 				break;
 			case cdt::configuration_t::Type::StaticLibrary:
-				master << "add_library (" << c.artifact << " STATIC";
+				if(pools.link_static)
+					properties += " JOB_POOL_LINK link_static";
 				break;
 			case cdt::configuration_t::Type::SharedLibrary:
-				master << "add_library (" << c.artifact << " SHARED";
+				if(pools.link_shared)
+					properties += " JOB_POOL_LINK link_shared";
 				break;
 		}
-		for(const auto& source_folder : sources)
+	}
+	if(!properties.empty())
+		master << "set_target_properties(" << target << " PROPERTIES" << properties << ")\n";
+}
+
+const cdt::configuration_t::build_folder* top_level_folder(const cdt::configuration_t& c)
+{
+	for(auto& bf : c.build_folders)
+	{
+		if(bf.path.empty())
+			return &bf;
+	}
+	return nullptr;
+}
+
+// Whether sources compiled for one can be used for the other; position
+// independence aside, as shared objects are compiled with it anyway.
+// Build settings only count when they are emitted.
+bool same_compile_settings(const cdt::configuration_t::build_folder::compiler_t& l, const cdt::configuration_t::build_folder::compiler_t& r,
+		bool build_settings)
+{
+	if(l.includes != r.includes || l.options != r.options)
+		return false;
+	return !build_settings ||
+		(l.defines == r.defines && l.optimization == r.optimization && l.debugging == r.debugging && l.standard == r.standard);
+}
+
+bool same_compile_settings(const cdt::configuration_t& l, const cdt::configuration_t& r, bool build_settings)
+{
+	auto l_bf = top_level_folder(l);
+	auto r_bf = top_level_folder(r);
+	if(!l_bf || !r_bf)
+		return l_bf == r_bf;
+	return same_compile_settings(l_bf->c.compiler, r_bf->c.compiler, build_settings) &&
+		same_compile_settings(l_bf->cpp.compiler, r_bf->cpp.compiler, build_settings);
+}
+
+std::string emit(const project_model& model)
+{
+	auto& project_name = model.name;
+	auto& sources = model.sources;
+
+	std::ostringstream master;
+	int minimum_version = 20800;
+
+	if(!model.pools.empty())
+	{
+		emit_job_pools(master, model.pools);
+		require(minimum_version, 30000);
+	}
+	if(!model.compiler_launcher.empty())
+	{
+		emit_compiler_launcher(master, model.compiler_launcher);
+		require(minimum_version, 30400);
+	}
+
+	/*
+	 * A static and a shared library of the same name: the static target
+	 * is renamed and keeps the name through OUTPUT_NAME. When they are
+	 * compiled alike, both link the objects of one OBJECT library.
+	 */
+	struct library_pair
+	{
+		std::string objects_target;
+		bool shared_objects;
+		bool objects_emitted;
+	};
+	std::vector<library_pair> pairs;
+	// both libraries of a pair -> its index in pairs
+	std::map<const cdt::configuration_t*, std::size_t> paired;
+	for(auto& ac : model.artifacts)
+	{
+		if(ac.second.type != cdt::configuration_t::Type::StaticLibrary)
+			continue;
+		auto shared = model.artifacts.find(ac.second.artifact + to_string(cdt::configuration_t::Type::SharedLibrary));
+		if(shared == model.artifacts.end())
+			continue;
+
+		paired[&ac.second] = paired[&shared->second] = pairs.size();
+		pairs.push_back({ac.second.artifact + "_objects", same_compile_settings(ac.second, shared->second, model.build_settings), false});
+	}
+
+	for(auto ac = model.artifacts.begin(); ac != model.artifacts.end(); ++ac)
+	{
+		auto& c = ac->second;
+		auto pair_index = paired.find(&c);
+		auto pair = pair_index == paired.end() ? nullptr : &pairs[pair_index->second];
+		bool renamed = pair && c.type == cdt::configuration_t::Type::StaticLibrary;
+		std::string target = c.artifact;
+		if(renamed)
+			target += "_static";
+		bool from_objects = pair && pair->shared_objects;
+		std::string objects_target = from_objects ? pair->objects_target : std::string();
+
+		if(from_objects && !pair->objects_emitted)
+		{
+			pair->objects_emitted = true;
+			master << "add_library (" << objects_target << " OBJECT";
+			emit_sources(master, model);
+			master << ")\n";
+			master << "set_target_properties(" << objects_target << " PROPERTIES POSITION_INDEPENDENT_CODE ON)\n";
+			emit_target_job_pools(master, objects_target, model.pools, true, nullptr);
+			if(model.unity_build)
+				emit_unity_build(master, objects_target, model, minimum_version);
+			if(auto bf = top_level_folder(c))
+				emit_compile_settings(master, objects_target, *bf, model, true, true, minimum_version);
+			require(minimum_version, 20808);
+		}
+		
+		switch(c.type)
 		{
-			for(const auto& source : source_folder.second)
-			{
-				master << (source_folder.second.size() > 3 ? "\n   " : " ") << (source_folder.first.empty() ? std::string{} : source_folder.first + "/") << source;
-			}
-			master << "\n";
+			case cdt::configuration_t::Type::Executable:
+				master << "add_executable (" << target;
+				break;
+			case cdt::configuration_t::Type::StaticLibrary:
+				master << "add_library (" << target << " STATIC";
+				break;
+			case cdt::configuration_t::Type::SharedLibrary:
+				master << "add_library (" << target << " SHARED";
+				break;
 		}
+		if(from_objects)
+			master << " $<TARGET_OBJECTS:" << objects_target << ">\n";
+		else
+			emit_sources(master, model);
 		master << ")\n";
 		
+		if(renamed)
+			master << "set_target_properties(" << target << " PROPERTIES OUTPUT_NAME " << c.artifact << ")\n";
+		emit_target_job_pools(master, target, model.pools, !from_objects, &c.type);
+		
+		if(model.unity_build && !from_objects)
+			emit_unity_build(master, target, model, minimum_version);
+		
 		if(!c.prebuild.empty() || !c.postbuild.empty())
 		{
 			master << "\n";
@@ -297,129 +979,9 @@ void generate(cdt::project& cdtproject, bool write_files)
 			if(bf.path.empty())
 			{
 				// master
-				
-				{
-					if(!bf.cpp.compiler.includes.empty() || !bf.c.compiler.includes.empty())
-					{
-						//master << "set_property (TARGET " << c.artifact << " PROPERTY INCLUDE_DIRECTORIES";
-						master << "INCLUDE_DIRECTORIES(";
-						if(lang_cxx)
-						{
-							for(auto& inc : bf.cpp.compiler.includes)
-								master << (bf.cpp.compiler.includes.size() > 3 ? "\n   " : " ") << '"' << inc << '"';
-						}
-						if(lang_c)
-						{
-							for(auto& inc : bf.c.compiler.includes)
-								master << (bf.c.compiler.includes.size() > 3 ? "\n   " : " ") << '"' << inc << '"';
-						}
-						master << ")\n\n";
-					}
-					
-					std::vector<std::string> options;
-					if(lang_cxx)
-					{
-						std::stringstream ss(bf.cpp.compiler.options);
-						std::vector<std::string> opts(std::istream_iterator<std::string>{ss}, std::istream_iterator<std::string>{});
-						for(auto& o : opts)
-						{
-							if(std::find(begin(options), end(options), o) == end(options))
-								options.push_back(o);
-						}
-					}
-					if(lang_c)
-					{
-						std::stringstream ss(bf.c.compiler.options);
-						std::vector<std::string> opts(std::istream_iterator<std::string>{ss}, std::istream_iterator<std::string>{});
-						for(auto& o : opts)
-						{
-							if(std::find(begin(options), end(options), o) == end(options))
-								options.push_back(o);
-						}
-					}
-					
-					if(!options.empty())
-					{
-						master << "set_target_properties(" << c.artifact << " PROPERTIES COMPILE_FLAGS \"";
-						for(auto& o : options)
-							master << o << ' ';
-						master << "\")\n\n";
-					}
-				}
-				
-				if(lang_cxx)
-				{
-					// use c++ linker settings.
-					if(!bf.cpp.linker.flags.empty())
-					{
-						std::vector<std::string> flags;
-						
-						std::stringstream ss(bf.cpp.linker.flags);
-						std::vector<std::string> opts(std::istream_iterator<std::string>{ss}, std::istream_iterator<std::string>{});
-						for(auto& o : opts)
-						{
-							if(std::find(begin(flags), end(flags), o) == end(flags))
-								flags.push_back(o);
-						}
-						
-						master << "set_target_properties(" << c.artifact << " PROPERTIES LINK_FLAGS \"";
-						for(auto& o : flags)
-							master << o << ' ';
-						master << "\")\n";
-					}
-				
-					if(!bf.cpp.linker.lib_paths.empty())
-					{
-						master << "link_directories (";
-						for(auto& path : bf.cpp.linker.lib_paths)
-							master << (bf.cpp.linker.lib_paths.size() > 3 ? "\n   " : " ") << path;
-						master << ")\n";
-					}
-
-					if(!bf.cpp.linker.libs.empty())
-					{
-						master << "target_link_libraries (" << c.artifact;
-						for(auto& lib : bf.cpp.linker.libs)
-							master << (bf.cpp.linker.libs.size() > 3 ? "\n   " : " ") << lib;
-						master << ")\n\n";
-					}
-				}
-				else
-				{
-					if(!bf.c.linker.flags.empty())
-					{
-						std::vector<std::string> flags;
-						
-						std::stringstream ss(bf.c.linker.flags);
-						std::vector<std::string> opts(std::istream_iterator<std::string>{ss}, std::istream_iterator<std::string>{});
-						for(auto& o : opts)
-						{
-							if(std::find(begin(flags), end(flags), o) == end(flags))
-								flags.push_back(o);
-						}
-						
-						master << "set_target_properties(" << c.artifact << " PROPERTIES LINK_FLAGS \"";
-						for(auto& o : flags)
-							master << o << ' ';
-						master << "\")\n";
-					}
-				
-					if(!bf.c.linker.lib_paths.empty())
-					{
-						master << "link_directories (";
-						for(auto& path : bf.c.linker.lib_paths)
-							master << (bf.c.linker.lib_paths.size() > 3 ? "\n   " : " ") << path;
-						master << ")\n";
-					}
-
-					if(!bf.c.linker.libs.empty())
-					{
-						master << "target_link_libraries (" << c.artifact;
-						for(auto& lib : bf.c.linker.libs)
-							master << (bf.c.linker.libs.size() > 3 ? "\n   " : " ") << lib;
-						master << ")\n\n";
-					}
-				}
+				if(!from_objects)
+					emit_compile_settings(master, target, bf, model, c.type == cdt::configuration_t::Type::SharedLibrary, false, minimum_version);
+				emit_link_settings(master, target, bf, model, minimum_version);
 			}
 			else
 			{
@@ -436,7 +998,260 @@ void generate(cdt::project& cdtproject, bool write_files)
 		}
 	}
 	
+	if(model.unity_build)
+	{
+		master << "\n";
+		if(!model.unity_batch_size)
+		{
+			for(const auto& source_folder : sources)
+			{
+				auto separator = source_folder.second.size() > 3 ? "\n   " : " ";
+				master << "set_source_files_properties(";
+				for(const auto& source : source_folder.second)
+					master << separator << (source_folder.first.empty() ? std::string{} : source_folder.first + "/") << source.name;
+				master << separator << "PROPERTIES UNITY_GROUP " << quote(source_folder.first.empty() ? "." : source_folder.first) << ")\n";
+			}
+		}
+
+		// sources with their own build settings are compiled on their own
+		ordered_set<istring> separate;
+		for(auto& ac : model.artifacts)
+		{
+			for(auto& bf : ac.second.build_files)
+			{
+				if(classify_source(bf.file) != language::none)
+					separate.insert(bf.file);
+			}
+		}
+		if(!separate.empty())
+		{
+			auto separator = separate.size() > 3 ? "\n   " : " ";
+			master << "set_source_files_properties(";
+			for(auto& file : separate)
+				master << separator << file;
+			master << separator << "PROPERTIES SKIP_UNITY_BUILD_INCLUSION ON)\n";
+		}
+	}
+
 	master << '\n';
+
+	// OBJECT libraries need 2.8.8, PRIVATE links 2.8.12, job pools 3.0,
+	// compiler launchers 3.4, linking OBJECT libraries 3.12,
+	// target_precompile_headers and unity builds 3.16, unity groups 3.18
+	std::ostringstream listfile;
+	listfile << "cmake_minimum_required (VERSION " << minimum_version / 10000 << '.' << minimum_version / 100 % 100;
+	if(minimum_version % 100)
+		listfile << '.' << minimum_version % 100;
+	listfile << ")\n";
+	listfile << "project (" << project_name << ")\n";
+	listfile << "\n";
+	listfile << master.str();
+	return listfile.str();
+}
+
+shared_settings share_settings(const std::vector<project_model*>& models, std::size_t min_projects)
+{
+	struct block_t
+	{
+		compile_settings compile;
+		link_settings link;
+		bool is_link = false;
+		std::size_t projects = 0;
+	};
+	std::map<std::uint64_t, block_t> blocks;
+
+	for(auto model : models)
+	{
+		std::set<std::uint64_t> used;
+		for(auto& artifact : model->artifacts)
+		{
+			for(auto& bf : artifact.second.build_folders)
+			{
+				if(!bf.path.empty())
+					continue;
+
+				auto compile = resolve_compile_settings(bf, *model);
+				if(auto digest = compile_digest(compile))
+				{
+					if(used.insert(digest).second && !blocks[digest].projects++)
+						blocks[digest].compile = std::move(compile);
+				}
+
+				auto link = resolve_link_settings(bf, *model);
+				if(auto digest = link_digest(link))
+				{
+					if(used.insert(digest).second && !blocks[digest].projects++)
+					{
+						blocks[digest].link = std::move(link);
+						blocks[digest].is_link = true;
+					}
+				}
+			}
+		}
+	}
+
+	shared_settings shared;
+	int minimum_version = 20800;
+	std::map<std::uint64_t, std::string> names;
+	for(auto& block : blocks)
+	{
+		if(block.second.projects < std::max<std::size_t>(min_projects, 2))
+			continue;
+
+		auto& b = block.second;
+		std::ostringstream name;
+		name << (b.is_link ? "shared_link_" : "shared_compile_") << std::hex << std::setw(16) << std::setfill('0') << block.first;
+		names[block.first] = name.str();
+
+		if(b.is_link)
+			shared.definitions += link_interface(name.str(), b.link) + "\n";
+		else
+			shared.definitions += compile_interface(name.str(), b.compile) + "\n";
+		require(minimum_version, b.is_link && (!b.link.flags.empty() || !b.link.lib_paths.empty()) ? 31300 : 30000);
+	}
+
+	for(auto model : models)
+	{
+		model->shared_blocks.clear();
+		for(auto& artifact : model->artifacts)
+		{
+			for(auto& bf : artifact.second.build_folders)
+			{
+				if(!bf.path.empty())
+					continue;
+				for(auto digest : {compile_digest(resolve_compile_settings(bf, *model)), link_digest(resolve_link_settings(bf, *model))})
+				{
+					auto name = names.find(digest);
+					if(name != names.end())
+						model->shared_blocks[digest] = name->second;
+				}
+			}
+		}
+	}
+
+	shared.minimum_version = std::to_string(minimum_version / 10000) + '.' + std::to_string(minimum_version / 100 % 100);
+	return shared;
+}
+
+namespace
+{
+
+std::string project_folder(const project_model& model)
+{
+	return model.path.empty() || model.path.back() == '/' ? model.path : model.path + '/';
+}
+
+void count_sources(project_model& model, const std::vector<source_file>& sources, int delta)
+{
+	for(auto& source : sources)
+		model.language_sources[static_cast<int>(source.lang)] += delta;
+}
+
+}
+
+void refresh_folder(project_model& model, const std::string& folder)
+{
+	auto it = model.sources.find(folder);
+	if(it != model.sources.end())
+	{
+		count_sources(model, it->second, -1);
+		model.sources.erase(it);
+	}
+
+	auto sources = directory_sources(project_folder(model), folder, classify_source, &model.filter);
+	count_sources(model, sources, 1);
+	if(!sources.empty())
+		model.sources[folder] = std::move(sources);
+}
+
+void rescan_tree(project_model& model, const std::string& folder, unsigned int threads)
+{
+	auto below = folder + '/';
+	for(auto it = model.sources.begin(); it != model.sources.end();)
+	{
+		if(folder.empty() || it->first == folder || it->first.compare(0, below.size(), below) == 0)
+		{
+			count_sources(model, it->second, -1);
+			it = model.sources.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	auto filter = model.filter.within(folder);
+	auto sources = find_sources(project_folder(model) + (folder.empty() ? "" : below), classify_source, threads, nullptr, &filter);
+	count_sources(model, sources, 1);
+	for(auto& source : sources)
+	{
+		if(!folder.empty())
+			source.path = source.path.empty() ? folder : below + source.path;
+		model.sources[source.path].push_back(std::move(source));
+	}
+}
+
+// Writes the rendered listfile into the project folder if its content
+// changed; returns whether it was written.
+bool write_listfile(const std::string& project_path, const std::string& listfile)
+{
+	auto filename = project_path + "/CMakeLists.txt";
+	auto written = write_file_if_changed(filename, listfile);
+	if(written == write_result::failed)
+		throw std::runtime_error("Unable to write " + filename);
+	return written == write_result::written;
+}
+
+bool write_listfile(const project_model& model)
+{
+	return write_listfile(model.path, emit(model));
+}
+
+project_model extract(const cdt::project& cdtproject, const options& opts, result& res, project_timings* timings)
+{
+	project_model model;
+	{
+		phase_timer timer(timings, phase::discovery);
+		discover(cdtproject, opts, model, res);
+	}
+	{
+		phase_timer timer(timings, phase::merge);
+		merge(cdtproject, model);
+	}
+
+	if(timings)
+	{
+		timings->configurations = cdtproject.cconfigurations().size();
+		for(auto& artifact : model.artifacts)
+			timings->folders += artifact.second.build_folders.size();
+		for(auto& folder : model.sources)
+			timings->sources += folder.second.size();
+	}
+	return model;
+}
+
+void render(const project_model& model, const options& opts, std::ostream& out, result& res, project_timings* timings)
+{
+	std::string listfile;
+	{
+		phase_timer timer(timings, phase::emit);
+		listfile = emit(model);
+		res.listfile_hash = fnv1a(listfile);
+	}
+
+	phase_timer timer(timings, phase::write);
+	if(opts.write_files)
+		res.listfile_unchanged = !write_listfile(model.path, listfile);
+	else
+		out << listfile;
+}
+
+// one step, take cdt files and write cmakelists.
+result generate(cdt::project& cdtproject, const options& opts, std::ostream& out, project_timings* timings)
+{
+	result res;
+	render(extract(cdtproject, opts, res, timings), opts, out, res, timings);
+	return res;
 }
 
 }
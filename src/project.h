@@ -9,18 +9,188 @@
 #define PROJECT_H_
 #include <string>
 #include <set>
+#include <map>
 #include <vector>
 #include <ostream>
+#include <cstdint>
+#include "sourcediscovery.h"
+#include "cdtconfiguration.h"
 
 namespace cdt
 {
 struct project;
 }
+struct project_timings;
 
 namespace cmake
 {
 
-void generate(cdt::project& cdtproject, bool write_files);
+// Ninja job pool sizes; 0 leaves those jobs out of any pool.
+struct job_pools
+{
+	unsigned int compile = 0;
+	unsigned int link_executable = 0;
+	unsigned int link_static = 0;
+	unsigned int link_shared = 0;
+
+	bool empty() const
+	{
+		return !compile && !link_executable && !link_static && !link_shared;
+	}
+};
+
+struct options
+{
+	// Write CMakeLists.txt to the project folder instead of the output stream.
+	// The file is replaced atomically, and only if its content changes.
+	bool write_files = false;
+
+	// Threads used to walk the project source tree.
+	unsigned int discovery_threads = 1;
+
+	// Record the directories walked so later runs can detect changes.
+	bool record_directories = false;
+
+	// Also emit the defines, optimization and debugging level, language
+	// standard and position independence set in the configurations.
+	bool build_settings = false;
+
+	// Use the headers force included with -include, or a common
+	// pch.h / stdafx.h in the tree, as precompiled headers.
+	bool precompiled_headers = false;
+
+	// Build each target as a unity build; sources are batched by
+	// unity_batch_size, or grouped by source folder when it is 0.
+	bool unity_build = false;
+	unsigned int unity_batch_size = 0;
+
+	// Define these JOB_POOLS and assign targets to them by artifact type.
+	job_pools pools;
+
+	// Compile through this tool (ccache, sccache) when it is found, with
+	// the compile flags normalized so equal settings give equal commands.
+	std::string compiler_launcher;
+
+	// Directory names not searched for sources, besides version control
+	// directories and the build output folders.
+	std::vector<std::string> ignored;
+};
+
+// Splits compiler or linker flags on whitespace.
+std::vector<std::string> split(const std::string& text);
+
+// Digest of the options that affect the generated listfile.
+std::uint64_t digest(const options& opts);
+
+struct result
+{
+	std::vector<source_directory> directories;
+	std::uint64_t sources_digest = 0;
+
+	// Hash of the generated listfile.
+	std::uint64_t listfile_hash = 0;
+
+	// With write_files, whether the listfile already had this content.
+	bool listfile_unchanged = false;
+};
+
+// What a listfile is generated from.
+struct project_model
+{
+	std::string name;
+	std::string path;
+
+	// source folder -> files
+	std::map<std::string, std::vector<source_file> > sources;
+
+	// number of sources per language, counted during discovery
+	std::size_t language_sources[static_cast<int>(language::count)] = {};
+	bool has_sources(language lang) const
+	{
+		return language_sources[static_cast<int>(lang)] != 0;
+	}
+
+	// configurations merged by artifact name and type
+	std::map<std::string, cdt::configuration_t> artifacts;
+
+	bool build_settings = false;
+
+	// With precompiled_headers; tree_header is the common header found
+	// in the tree for artifacts whose flags do not name one.
+	bool precompiled_headers = false;
+	std::string tree_header;
+
+	bool unity_build = false;
+	unsigned int unity_batch_size = 0;
+
+	job_pools pools;
+
+	// With a compiler_launcher; workspace_path is the absolute path of
+	// the folder ${CMAKE_SOURCE_DIR} stands for, the project's parent.
+	std::string compiler_launcher;
+	std::string workspace_path;
+
+	// the folders and files that hold sources, for incremental discovery
+	source_filter filter;
+
+	// digest of a settings block -> the INTERFACE library that provides
+	// it, filled in by share_settings
+	std::map<std::uint64_t, std::string> shared_blocks;
+};
+
+// Limits the filter to the source entries of the configuration, and
+// leaves out its build output folder.
+void add_source_entries(source_filter& filter, const cdt::configuration_t& conf);
+
+/*
+ * The phases of generate, exposed separately so they can be timed.
+ * discover walks the source tree, merge folds the cdt configurations
+ * into one per artifact and emit renders the listfile.
+ */
+void discover(const cdt::project& cdtproject, const options& opts, project_model& model, result& res);
+void merge(const cdt::project& cdtproject, project_model& model);
+std::string emit(const project_model& model);
+
+/*
+ * Incremental discovery for a model kept in memory. refresh_folder
+ * reads the sources directly in one source folder again; rescan_tree
+ * walks a folder and everything below it again, dropping it when it no
+ * longer exists. Folders are relative to the project, "" for its root.
+ */
+void refresh_folder(project_model& model, const std::string& folder);
+void rescan_tree(project_model& model, const std::string& folder, unsigned int threads = 1);
+
+// Renders the model and writes it to CMakeLists.txt in the project
+// folder if its content changed. Returns whether it was written.
+bool write_listfile(const project_model& model);
+
+/*
+ * generate in two steps. extract builds the model from the cdt project,
+ * which the caller can then release before render emits the listfile
+ * and writes it (or sends it to out). The model only holds the merged
+ * configurations and the source lists, not the parsed descriptors.
+ */
+project_model extract(const cdt::project& cdtproject, const options& opts, result& res, project_timings* timings = nullptr);
+void render(const project_model& model, const options& opts, std::ostream& out, result& res, project_timings* timings = nullptr);
+
+/*
+ * The compile and the link settings of a model's top level folders form
+ * settings blocks. Blocks used alike by at least min_projects (and two)
+ * of the models are defined once as INTERFACE libraries, which the
+ * targets of those models link instead of repeating the settings. The
+ * definitions belong in the top level listfile, ahead of the projects.
+ */
+struct shared_settings
+{
+	std::string definitions;
+
+	// the CMake version the definitions need, as in cmake_minimum_required
+	std::string minimum_version;
+};
+shared_settings share_settings(const std::vector<project_model*>& models, std::size_t min_projects = 2);
+
+// timings, if given, receives the time spent in each phase and the counts.
+result generate(cdt::project& cdtproject, const options& opts, std::ostream& out, project_timings* timings = nullptr);
 
 }
 
@@ -6,88 +6,368 @@
  */
 
 #include "sourcediscovery.h"
+#include "treewalk.h"
+#include "fileio.h"
+#include "hash.h"
 #include <algorithm>
-#include <dirent.h>
+#include <iterator>
+#include <mutex>
+#include <cstring>
 
-bool is_source_filename(const std::string& filename)
+namespace
 {
-	static const auto c_types = {".c", ".C", "c++", ".cc", ".cpp", ".cxx"};
 
-	std::string::size_type pos = filename.rfind('.');
-	if(pos == std::string::npos)
-		return false;
+struct suffix_t
+{
+	const char* suffix;
+	std::size_t length;
+	language lang;
+};
+
+const suffix_t source_suffixes[] = {
+	{".c", 2, language::c},
+	{".C", 2, language::cxx},
+	{".cc", 3, language::cxx},
+	{".c++", 4, language::cxx},
+	{".cpp", 4, language::cxx},
+	{".cxx", 4, language::cxx}
+};
 
-	auto file_type = filename.substr(pos);
-	return std::find(begin(c_types), end(c_types), file_type) != end(c_types);
 }
 
-bool is_c_source_filename(const std::string& filename)
+language classify_source(const char* filename, std::size_t length)
 {
-	static const auto c_types = {".c"};
+	// every suffix starts with ".c" or ".C" and is at most four characters
+	for(std::size_t n = 2; n <= 4 && n <= length; ++n)
+	{
+		auto suffix = filename + length - n;
+		if(suffix[0] != '.')
+			continue;
 
-	std::string::size_type pos = filename.rfind('.');
-	if(pos == std::string::npos)
-		return false;
+		for(auto& known : source_suffixes)
+		{
+			if(known.length == n && std::memcmp(known.suffix, suffix, n) == 0)
+				return known.lang;
+		}
+		return language::none;
+	}
+	return language::none;
+}
+
+language classify_source(const std::string& filename)
+{
+	return classify_source(filename.data(), filename.size());
+}
+
+bool is_source_filename(const std::string& filename)
+{
+	return classify_source(filename) != language::none;
+}
 
-	auto file_type = filename.substr(pos);
-	return std::find(begin(c_types), end(c_types), file_type) != end(c_types);
+bool is_c_source_filename(const std::string& filename)
+{
+	return classify_source(filename) == language::c;
 }
 bool is_cxx_source_filename(const std::string& filename)
 {
-	static const auto c_types = {".C", "c++", ".cc", ".cpp", ".cxx"};
+	return classify_source(filename) == language::cxx;
+}
+
+namespace
+{
+
+std::string join_path(const std::string& folder, const std::string& name)
+{
+	return folder.empty() ? name : folder + '/' + name;
+}
+
+// Whether path is folder or lies below it.
+bool is_within(const std::string& path, const std::string& folder)
+{
+	return folder.empty() || (path.compare(0, folder.size(), folder) == 0 && (path.size() == folder.size() || path[folder.size()] == '/'));
+}
+
+bool is_below(const std::string& path, const std::string& folder)
+{
+	return path.size() > folder.size() && is_within(path, folder);
+}
 
-	std::string::size_type pos = filename.rfind('.');
-	if(pos == std::string::npos)
+// Whether a configuration with these entries has path as a source.
+bool entries_include(const std::vector<source_filter::entry>& entries, const std::string& path)
+{
+	const source_filter::entry* closest = nullptr;
+	for(auto& entry : entries)
+	{
+		if(is_within(path, entry.path) && (!closest || entry.path.size() > closest->path.size()))
+			closest = &entry;
+	}
+	if(!closest)
 		return false;
 
-	auto file_type = filename.substr(pos);
-	return std::find(begin(c_types), end(c_types), file_type) != end(c_types);
+	for(auto& excluded : closest->excluding)
+	{
+		if(is_within(path, excluded))
+			return false;
+	}
+	return true;
+}
+
+}
+
+source_filter::source_filter()
+ : names{".git", ".hg", ".svn"}
+{
 }
 
-void find_sources(const std::string& base_path, const std::string& path, const std::function<bool(std::string)>& predicate, std::vector<source_file>& sources)
+void source_filter::add_configuration(const std::vector<entry>& entries)
 {
-	auto abs_path = base_path;
+	// exclusions are kept relative to the project
+	std::vector<entry> resolved;
+	for(auto& e : entries)
+	{
+		entry r{e.path, {}};
+		for(auto& excluded : e.excluding)
+			r.excluding.push_back(join_path(e.path, excluded));
+		resolved.push_back(std::move(r));
+	}
+	if(resolved.empty())
+		resolved.push_back(entry{});
+	configurations.push_back(std::move(resolved));
+}
 
-	if(!path.empty())
-		abs_path += "/" + path;
+void source_filter::ignore_name(const std::string& name)
+{
+	if(std::find(names.begin(), names.end(), name) == names.end())
+		names.push_back(name);
+}
 
-	auto d = opendir(abs_path.c_str());
-	if(d)
+void source_filter::ignore_folder(const std::string& folder)
+{
+	folders.push_back(folder);
+}
+
+source_filter source_filter::within(const std::string& folder) const
+{
+	auto filter = *this;
+	filter.base = project_path(folder);
+	return filter;
+}
+
+bool source_filter::descend(const std::string& folder) const
+{
+	auto path = project_path(folder);
+
+	for(std::size_t begin = 0; begin < path.size();)
 	{
-		while (auto dir = readdir(d))
+		auto end = std::min(path.find('/', begin), path.size());
+		if(std::find(names.begin(), names.end(), path.substr(begin, end - begin)) != names.end())
+			return false;
+		begin = end + 1;
+	}
+
+	for(auto& ignored : folders)
+	{
+		if(!is_within(path, ignored))
+			continue;
+
+		// unless it is, or leads to, a source entry named within it
+		bool listed = false;
+		for(auto& entries : configurations)
 		{
-			std::string name = dir->d_name;
-			if(dir->d_type == DT_DIR)
+			for(auto& entry : entries)
 			{
-				if(name == "." || name == "..")
-					continue;
+				if(is_within(entry.path, ignored) && (is_within(path, entry.path) || is_below(entry.path, path)))
+					listed = true;
+			}
+		}
+		if(!listed)
+			return false;
+	}
+
+	if(configurations.empty())
+		return true;
+	for(auto& entries : configurations)
+	{
+		if(entries_include(entries, path))
+			return true;
+		for(auto& entry : entries)
+		{
+			if(is_below(entry.path, path))
+				return true;
+		}
+	}
+	return false;
+}
 
-				auto rel_path = name;
-				if(!path.empty())
-					rel_path = path + "/" + name;
+bool source_filter::whole_folder(const std::string& folder) const
+{
+	if(configurations.empty())
+		return true;
 
-				find_sources(base_path, rel_path, predicate, sources);
-			}
-			else if(dir->d_type == DT_REG)
+	auto path = project_path(folder);
+	for(auto& entries : configurations)
+	{
+		if(!entries_include(entries, path))
+			continue;
+
+		bool excludes_below = false;
+		for(auto& entry : entries)
+		{
+			for(auto& excluded : entry.excluding)
 			{
-				if(predicate(name))
-				{
-					auto rel_source = name;
-					if(!path.empty())
-						rel_source = path + "/" + name;
-
-					sources.push_back({name, path});
-				}
+				if(is_below(excluded, path))
+					excludes_below = true;
 			}
 		}
-		closedir(d);
+		if(!excludes_below)
+			return true;
+	}
+	return false;
+}
+
+bool source_filter::includes(const std::string& folder, const std::string& name) const
+{
+	if(configurations.empty())
+		return true;
+
+	auto path = join_path(project_path(folder), name);
+	for(auto& entries : configurations)
+	{
+		if(entries_include(entries, path))
+			return true;
 	}
+	return false;
 }
 
-std::vector<source_file> find_sources(const std::string& base_path, const std::function<bool(std::string)>& predicate)
+std::string source_filter::project_path(const std::string& path) const
+{
+	if(base.empty())
+		return path;
+	return path.empty() ? base : base + '/' + path;
+}
+
+namespace
+{
+
+std::uint64_t directory_digest(std::vector<std::string>& names, std::vector<std::string> subdirs)
+{
+	// entry order from the filesystem is not stable
+	std::sort(names.begin(), names.end());
+	std::sort(subdirs.begin(), subdirs.end());
+
+	auto digest = fnv1a_seed;
+	for(auto& name : names)
+		digest = fnv1a(name, digest);
+	digest = fnv1a("/", 1, digest);
+	for(auto& name : subdirs)
+		digest = fnv1a(name, digest);
+	return digest;
+}
+
+}
+
+std::vector<source_file> find_sources(const std::string& base_path, source_classifier classify, unsigned int threads,
+		std::vector<source_directory>* directories, const source_filter* filter)
 {
 	std::vector<source_file> sources;
-	find_sources(base_path, {}, predicate, sources);
+	std::mutex sources_mutex;
+
+	if(filter && !filter->descend({}))
+		return sources;
+
+	walk_tree(base_path, [&](const std::string& path, int fd, const std::vector<const char*>& files, std::vector<std::string>& subdirs)
+	{
+		std::vector<source_file> found;
+		for(auto file : files)
+		{
+			auto lang = classify(file, std::strlen(file));
+			if(lang != language::none)
+				found.push_back({file, path, lang});
+		}
+
+		// digested as directory_digest reads the directory, before filtering
+		if(directories)
+		{
+			std::vector<std::string> names;
+			for(auto& source : found)
+				names.push_back(source.name);
+
+			source_directory dir{path, stat_file(fd).mtime, directory_digest(names, subdirs)};
+			std::lock_guard<std::mutex> lock(sources_mutex);
+			directories->push_back(dir);
+		}
+
+		if(filter)
+		{
+			if(!filter->whole_folder(path))
+				found.erase(std::remove_if(found.begin(), found.end(), [&](const source_file& source){ return !filter->includes(path, source.name); }), found.end());
+			subdirs.erase(std::remove_if(subdirs.begin(), subdirs.end(), [&](const std::string& name){ return !filter->descend(join_path(path, name)); }), subdirs.end());
+		}
+
+		if(found.empty())
+			return;
+
+		std::lock_guard<std::mutex> lock(sources_mutex);
+		std::move(found.begin(), found.end(), std::back_inserter(sources));
+	}, threads);
+
+	std::sort(sources.begin(), sources.end(), [](const source_file& l, const source_file& r)
+	{
+		return l.path < r.path || (l.path == r.path && l.name < r.name);
+	});
+	if(directories)
+	{
+		std::sort(directories->begin(), directories->end(), [](const source_directory& l, const source_directory& r)
+		{
+			return l.path < r.path;
+		});
+	}
+	return sources;
+}
+
+std::vector<source_file> directory_sources(const std::string& base_path, const std::string& rel_path, source_classifier classify,
+		const source_filter* filter)
+{
+	std::vector<source_file> sources;
+	if(filter && !filter->descend(rel_path))
+		return sources;
+
+	std::vector<std::string> files;
+	std::vector<std::string> subdirs;
+	list_directory(rel_path.empty() ? base_path : base_path + rel_path, files, subdirs);
+
+	bool whole = !filter || filter->whole_folder(rel_path);
+	for(auto& file : files)
+	{
+		auto lang = classify(file.data(), file.size());
+		if(lang != language::none && (whole || filter->includes(rel_path, file)))
+			sources.push_back({file, rel_path, lang});
+	}
+	std::sort(sources.begin(), sources.end(), [](const source_file& l, const source_file& r)
+	{
+		return l.name < r.name;
+	});
+	return sources;
+}
+
+std::uint64_t sources_digest(const std::vector<source_file>& sources)
+{
+	auto digest = fnv1a_seed;
+	for(auto& source : sources)
+	{
+		digest = fnv1a(source.path, digest);
+		digest = fnv1a(source.name, digest);
+	}
+	return digest;
+}
+
+std::uint64_t directory_digest(const std::string& path, source_classifier classify)
+{
+	std::vector<std::string> files;
+	std::vector<std::string> subdirs;
+	if(!list_directory(path, files, subdirs))
+		return 0;
 
-	return std::move(sources);
+	files.erase(std::remove_if(files.begin(), files.end(), [&](const std::string& name){ return classify(name.data(), name.size()) == language::none; }), files.end());
+	return directory_digest(files, subdirs);
 }
@@ -9,7 +9,22 @@
 #define SOURCEDISCOVERY_H_
 #include <string>
 #include <vector>
-#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+enum class language
+{
+	none,
+	c,
+	cxx,
+	count
+};
+
+// Classifies a file name by its suffix without allocating.
+language classify_source(const char* filename, std::size_t length);
+language classify_source(const std::string& filename);
+
+typedef language (*source_classifier)(const char* filename, std::size_t length);
 
 bool is_source_filename(const std::string& filename);
 bool is_c_source_filename(const std::string& filename);
@@ -19,8 +34,84 @@ struct source_file
 {
 	std::string name;
 	std::string path;
+	language lang;
+};
+
+struct source_directory
+{
+	std::string path;
+	std::int64_t mtime;
+
+	// digest of the matching file names and subdirectory names
+	std::uint64_t digest;
+};
+
+/*
+ * Which folders and files of a project hold sources. A path is a source
+ * if any configuration added has it below one of its source entries
+ * (the closest one, when entries nest) and that entry does not exclude
+ * it; with no configurations every path is. Directories with an ignored
+ * name are skipped anywhere in the tree, and ignored folders unless a
+ * source entry lies within them. Paths are relative to the project, ""
+ * for the project itself.
+ */
+class source_filter
+{
+public:
+	struct entry
+	{
+		std::string path;
+
+		// relative to path
+		std::vector<std::string> excluding;
+	};
+
+	// Version control directories are ignored from the start.
+	source_filter();
+
+	// No entries means the whole project.
+	void add_configuration(const std::vector<entry>& entries);
+	void ignore_name(const std::string& name);
+	void ignore_folder(const std::string& folder);
+
+	// A copy whose paths are relative to folder instead.
+	source_filter within(const std::string& folder) const;
+
+	// Whether the directory may hold sources and has to be walked.
+	bool descend(const std::string& folder) const;
+
+	// Whether every file directly in folder is a source, so the files
+	// need not be checked one by one.
+	bool whole_folder(const std::string& folder) const;
+
+	bool includes(const std::string& folder, const std::string& name) const;
+private:
+	std::string base;
+	std::vector<std::vector<entry> > configurations;
+	std::vector<std::string> names;
+	std::vector<std::string> folders;
+
+	std::string project_path(const std::string& path) const;
 };
 
-std::vector<source_file> find_sources(const std::string& base_path, const std::function<bool(std::string)>& predicate = is_source_filename);
+// Returns the files the classifier assigns a language, with that
+// language, sorted by path then name.
+// If directories is given it receives every directory walked, with its
+// modification time and content digest, sorted by path.
+// With a filter, only the folders and files it includes are reported.
+std::vector<source_file> find_sources(const std::string& base_path, source_classifier classify = classify_source, unsigned int threads = 1,
+		std::vector<source_directory>* directories = nullptr, const source_filter* filter = nullptr);
+
+// The sources directly in base_path + rel_path, as find_sources would
+// report them for that directory, sorted by name.
+std::vector<source_file> directory_sources(const std::string& base_path, const std::string& rel_path, source_classifier classify = classify_source,
+		const source_filter* filter = nullptr);
+
+// Digest of a source list as returned by find_sources.
+std::uint64_t sources_digest(const std::vector<source_file>& sources);
+
+// Reads the directory again and returns the digest find_sources would
+// have recorded for it, or 0 if it cannot be read.
+std::uint64_t directory_digest(const std::string& path, source_classifier classify = classify_source);
 
 #endif /* SOURCEDISCOVERY_H_ */
@@ -0,0 +1,224 @@
+/*
+ * timings.cpp
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#include "timings.h"
+#include "json.h"
+#include <algorithm>
+#include <iomanip>
+#include <time.h>
+
+namespace
+{
+
+const int phase_count = static_cast<int>(phase::count);
+
+std::int64_t clock_ns(clockid_t clock)
+{
+	struct timespec ts;
+	clock_gettime(clock, &ts);
+	return static_cast<std::int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+double ms(std::int64_t ns)
+{
+	return ns / 1e6;
+}
+
+struct totals_t
+{
+	phase_time phases[phase_count];
+	std::size_t configurations = 0;
+	std::size_t folders = 0;
+	std::size_t sources = 0;
+	std::uint64_t xml_bytes = 0;
+};
+
+totals_t sum(const std::vector<project_timings>& projects)
+{
+	totals_t totals;
+	for(auto& project : projects)
+	{
+		for(int p = 0; p < phase_count; ++p)
+		{
+			totals.phases[p].wall += project.phases[p].wall;
+			totals.phases[p].cpu += project.phases[p].cpu;
+		}
+		totals.configurations += project.configurations;
+		totals.folders += project.folders;
+		totals.sources += project.sources;
+		totals.xml_bytes += project.xml_bytes;
+	}
+	return totals;
+}
+
+std::vector<const project_timings*> slowest_projects(const std::vector<project_timings>& projects, std::size_t n)
+{
+	std::vector<const project_timings*> order;
+	for(auto& project : projects)
+		order.push_back(&project);
+
+	n = std::min(n, order.size());
+	std::partial_sort(order.begin(), order.begin() + n, order.end(), [](const project_timings* a, const project_timings* b)
+	{
+		return a->total_wall() > b->total_wall();
+	});
+	order.resize(n);
+	return order;
+}
+
+void write_phases(std::ostream& os, const phase_time* phases)
+{
+	os << '{';
+	for(int p = 0; p < phase_count; ++p)
+	{
+		os << (p ? ", " : "") << '"' << to_string(static_cast<phase>(p)) << "\": {\"wall_ms\": " << ms(phases[p].wall) << ", \"cpu_ms\": " << ms(phases[p].cpu) << '}';
+	}
+	os << '}';
+}
+
+}
+
+const char* to_string(phase p)
+{
+	switch(p)
+	{
+		case phase::cache:
+			return "cache";
+		case phase::parse:
+			return "parse";
+		case phase::discovery:
+			return "discovery";
+		case phase::merge:
+			return "merge";
+		case phase::emit:
+			return "emit";
+		case phase::write:
+			return "write";
+		case phase::count:
+			break;
+	}
+	return "unknown";
+}
+
+std::int64_t project_timings::total_wall() const
+{
+	std::int64_t total = 0;
+	for(auto& time : phases)
+		total += time.wall;
+	return total;
+}
+
+phase_time thread_now()
+{
+	phase_time t;
+	t.wall = clock_ns(CLOCK_MONOTONIC);
+	t.cpu = clock_ns(CLOCK_THREAD_CPUTIME_ID);
+	return t;
+}
+
+phase_time process_now()
+{
+	phase_time t;
+	t.wall = clock_ns(CLOCK_MONOTONIC);
+	t.cpu = clock_ns(CLOCK_PROCESS_CPUTIME_ID);
+	return t;
+}
+
+phase_timer::phase_timer(project_timings* timings, phase p)
+ : time(timings ? &timings->phases[static_cast<int>(p)] : nullptr)
+{
+	if(time)
+		start = thread_now();
+}
+
+phase_timer::~phase_timer()
+{
+	if(!time)
+		return;
+
+	auto end = thread_now();
+	time->wall += end.wall - start.wall;
+	time->cpu += end.cpu - start.cpu;
+}
+
+void write_summary(std::ostream& os, const std::vector<project_timings>& projects, const phase_time& run, std::size_t slowest)
+{
+	auto totals = sum(projects);
+	auto flags = os.flags();
+	os << std::fixed << std::setprecision(3);
+
+	os << "Timings: " << projects.size() << " projects, " << ms(run.wall) << " ms wall, " << ms(run.cpu) << " ms cpu\n";
+	os << "  phase        wall ms      cpu ms\n";
+	for(int p = 0; p < phase_count; ++p)
+	{
+		os << "  " << std::left << std::setw(10) << to_string(static_cast<phase>(p)) << std::right
+				<< std::setw(10) << ms(totals.phases[p].wall) << "  " << std::setw(10) << ms(totals.phases[p].cpu) << "\n";
+	}
+	os << "  " << totals.configurations << " configurations, " << totals.folders << " folders, "
+			<< totals.sources << " sources, " << totals.xml_bytes << " bytes of XML\n";
+
+	auto order = slowest_projects(projects, slowest);
+	if(!order.empty())
+		os << "Slowest projects:\n";
+	for(auto project : order)
+	{
+		os << "  " << std::setw(10) << ms(project->total_wall()) << " ms  " << project->project << " (" << project->status;
+		for(int p = 0; p < phase_count; ++p)
+		{
+			if(project->phases[p].wall)
+				os << ", " << to_string(static_cast<phase>(p)) << ' ' << ms(project->phases[p].wall);
+		}
+		os << ")\n";
+	}
+
+	os.flags(flags);
+}
+
+void write_json(std::ostream& os, const std::vector<project_timings>& projects, const phase_time& run, std::size_t slowest)
+{
+	auto totals = sum(projects);
+
+	os << "{\n";
+	os << "  \"wall_ms\": " << ms(run.wall) << ",\n";
+	os << "  \"cpu_ms\": " << ms(run.cpu) << ",\n";
+	os << "  \"phases\": ";
+	write_phases(os, totals.phases);
+	os << ",\n";
+	os << "  \"configurations\": " << totals.configurations << ",\n";
+	os << "  \"folders\": " << totals.folders << ",\n";
+	os << "  \"sources\": " << totals.sources << ",\n";
+	os << "  \"xml_bytes\": " << totals.xml_bytes << ",\n";
+
+	os << "  \"slowest\": [";
+	auto order = slowest_projects(projects, slowest);
+	for(std::size_t i = 0; i < order.size(); ++i)
+	{
+		os << (i ? ", " : "");
+		write_json_string(os, order[i]->project);
+	}
+	os << "],\n";
+
+	os << "  \"projects\": [";
+	for(std::size_t i = 0; i < projects.size(); ++i)
+	{
+		auto& project = projects[i];
+		os << (i ? "," : "") << "\n    {\"project\": ";
+		write_json_string(os, project.project);
+		os << ", \"status\": ";
+		write_json_string(os, project.status);
+		os << ", \"wall_ms\": " << ms(project.total_wall());
+		os << ", \"configurations\": " << project.configurations;
+		os << ", \"folders\": " << project.folders;
+		os << ", \"sources\": " << project.sources;
+		os << ", \"xml_bytes\": " << project.xml_bytes;
+		os << ", \"phases\": ";
+		write_phases(os, project.phases);
+		os << '}';
+	}
+	os << "\n  ]\n";
+	os << "}\n";
+}
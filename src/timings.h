@@ -0,0 +1,76 @@
+/*
+ * timings.h
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#ifndef TIMINGS_H_
+#define TIMINGS_H_
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstdint>
+
+enum class phase
+{
+	cache,		// up to date check against the cache manifest
+	parse,		// reading .project and .cproject
+	discovery,	// walking the source tree
+	merge,		// folding configurations per artifact
+	emit,		// rendering the listfile
+	write,		// writing the listfile or the output stream
+	count
+};
+
+const char* to_string(phase p);
+
+struct phase_time
+{
+	std::int64_t wall = 0;	// nanoseconds
+	std::int64_t cpu = 0;	// nanoseconds of the converting thread
+};
+
+struct project_timings
+{
+	std::string project;
+	std::string status;
+
+	phase_time phases[static_cast<int>(phase::count)];
+
+	std::size_t configurations = 0;
+	std::size_t folders = 0;
+	std::size_t sources = 0;
+	std::uint64_t xml_bytes = 0;
+
+	std::int64_t total_wall() const;
+};
+
+/*
+ * Adds the wall and thread CPU time between construction and
+ * destruction to a phase. Does nothing when timings is null so callers
+ * can time unconditionally.
+ */
+class phase_timer
+{
+public:
+	phase_timer(project_timings* timings, phase p);
+	~phase_timer();
+
+	phase_timer(const phase_timer&) = delete;
+	phase_timer& operator=(const phase_timer&) = delete;
+private:
+	phase_time* time;
+	phase_time start;
+};
+
+// Current wall clock with the CPU time of this thread or of the process.
+phase_time thread_now();
+phase_time process_now();
+
+// Totals per phase and counts, then the slowest projects by wall time.
+// run is the wall and process CPU time of the whole run.
+void write_summary(std::ostream& os, const std::vector<project_timings>& projects, const phase_time& run, std::size_t slowest);
+void write_json(std::ostream& os, const std::vector<project_timings>& projects, const phase_time& run, std::size_t slowest);
+
+#endif /* TIMINGS_H_ */
@@ -0,0 +1,199 @@
+/*
+ * treewalk.cpp
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#include "treewalk.h"
+#include "workerpool.h"
+#include <memory>
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace
+{
+
+// Past this many open directory descriptors subtrees are walked inline
+// instead of being queued, which keeps us well clear of RLIMIT_NOFILE.
+const int max_open_directories = 256;
+
+struct directory_t
+{
+	int fd;
+	std::atomic<int>& open_count;
+
+	directory_t(int fd, std::atomic<int>& open_count)
+	 : fd(fd), open_count(open_count)
+	{
+		++open_count;
+	}
+	~directory_t()
+	{
+		close(fd);
+		--open_count;
+	}
+};
+typedef std::shared_ptr<directory_t> directory_ptr;
+
+struct walk_t
+{
+	const directory_visitor& visit;
+	worker_pool* pool;
+	std::atomic<int> open_directories;
+};
+
+#ifdef __linux__
+struct linux_dirent64
+{
+	ino64_t d_ino;
+	off64_t d_off;
+	unsigned short d_reclen;
+	unsigned char d_type;
+	char d_name[];
+};
+#endif
+
+unsigned char entry_type(int dir_fd, const char* name, unsigned char type)
+{
+	if(type != DT_UNKNOWN)
+		return type;
+
+	// Some filesystems (notably NFS and XFS) do not fill in d_type.
+	struct stat st;
+	if(fstatat(dir_fd, name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+		return DT_UNKNOWN;
+	if(S_ISDIR(st.st_mode))
+		return DT_DIR;
+	if(S_ISREG(st.st_mode))
+		return DT_REG;
+	return DT_UNKNOWN;
+}
+
+bool is_dot(const char* name)
+{
+	return name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0));
+}
+
+/*
+ * Reads every entry of the directory. Names of regular files are packed
+ * into one buffer, names of subdirectories are returned separately.
+ */
+void read_directory(int fd, std::vector<char>& file_names, std::vector<std::string>& subdirs)
+{
+	auto add_entry = [&](const char* name, unsigned char type)
+	{
+		if(is_dot(name))
+			return;
+
+		switch(entry_type(fd, name, type))
+		{
+			case DT_DIR:
+				subdirs.emplace_back(name);
+				break;
+			case DT_REG:
+				file_names.insert(file_names.end(), name, name + std::strlen(name) + 1);
+				break;
+		}
+	};
+
+#ifdef __linux__
+	static const std::size_t buffer_size = 128 * 1024;
+	thread_local std::unique_ptr<char[]> buffer(new char[buffer_size]);
+
+	for(;;)
+	{
+		auto n = syscall(SYS_getdents64, fd, buffer.get(), buffer_size);
+		if(n <= 0)
+			break;
+
+		for(long pos = 0; pos < n;)
+		{
+			auto dir = reinterpret_cast<linux_dirent64*>(buffer.get() + pos);
+			add_entry(dir->d_name, dir->d_type);
+			pos += dir->d_reclen;
+		}
+	}
+#else
+	auto d = fdopendir(dup(fd));
+	if(!d)
+		return;
+	while(auto dir = readdir(d))
+		add_entry(dir->d_name, dir->d_type);
+	closedir(d);
+#endif
+}
+
+void walk_directory(walk_t& walk, const directory_ptr& dir, const std::string& rel_path)
+{
+	std::vector<char> file_names;
+	std::vector<std::string> subdirs;
+	read_directory(dir->fd, file_names, subdirs);
+
+	{
+		std::vector<const char*> files;
+		for(std::size_t pos = 0; pos < file_names.size(); pos += std::strlen(&file_names[pos]) + 1)
+			files.push_back(&file_names[pos]);
+		walk.visit(rel_path, dir->fd, files, subdirs);
+	}
+
+	for(auto& name : subdirs)
+	{
+		auto child_path = rel_path.empty() ? name : rel_path + '/' + name;
+
+		auto walk_child = [&walk, dir, name, child_path]
+		{
+			int fd = openat(dir->fd, name.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+			if(fd < 0)
+				return;
+
+			walk_directory(walk, std::make_shared<directory_t>(fd, walk.open_directories), child_path);
+		};
+
+		if(walk.pool && walk.open_directories < max_open_directories)
+			walk.pool->run(walk_child);
+		else
+			walk_child();
+	}
+}
+
+}
+
+void walk_tree(const std::string& base_path, const directory_visitor& visit, unsigned int threads)
+{
+	int fd = open(base_path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if(fd < 0)
+		return;
+
+	std::unique_ptr<worker_pool> pool;
+	if(threads > 1)
+		pool.reset(new worker_pool(threads));
+
+	walk_t walk{visit, pool.get(), {0}};
+	walk_directory(walk, std::make_shared<directory_t>(fd, walk.open_directories), {});
+
+	if(pool)
+		pool->wait();
+}
+
+bool list_directory(const std::string& path, std::vector<std::string>& files, std::vector<std::string>& subdirs)
+{
+	int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if(fd < 0)
+		return false;
+
+	std::vector<char> file_names;
+	read_directory(fd, file_names, subdirs);
+	close(fd);
+
+	for(std::size_t pos = 0; pos < file_names.size(); pos += std::strlen(&file_names[pos]) + 1)
+		files.emplace_back(&file_names[pos]);
+	return true;
+}
@@ -0,0 +1,35 @@
+/*
+ * treewalk.h
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#ifndef TREEWALK_H_
+#define TREEWALK_H_
+#include <string>
+#include <vector>
+#include <functional>
+
+/*
+ * Called once for every directory under the walk root with the path
+ * relative to the root ("" for the root itself), an open descriptor for
+ * the directory, the names of the regular files it contains and the
+ * names of its subdirectories. Subdirectories the visitor removes from
+ * the list are not walked. The descriptor and names are only valid for
+ * the duration of the call. With more than one thread the visitor is
+ * invoked concurrently for different directories.
+ */
+typedef std::function<void(const std::string& rel_path, int fd, const std::vector<const char*>& files, std::vector<std::string>& subdirs)> directory_visitor;
+
+/*
+ * Walks the tree below base_path without following symlinks.
+ * Directories are opened relative to their parent descriptor and read
+ * with large getdents64 buffers; subtrees are spread across threads.
+ */
+void walk_tree(const std::string& base_path, const directory_visitor& visit, unsigned int threads = 1);
+
+// Reads a single directory. Returns false if it cannot be opened.
+bool list_directory(const std::string& path, std::vector<std::string>& files, std::vector<std::string>& subdirs);
+
+#endif /* TREEWALK_H_ */
@@ -0,0 +1,360 @@
+/*
+ * watch.cpp
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#include "watch.h"
+#include "project.h"
+#include "cdtproject.h"
+#include "sourcediscovery.h"
+#include "treewalk.h"
+#include "workerpool.h"
+#include <iostream>
+#include <set>
+#include <algorithm>
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+std::string join_path(const std::string& folder, const std::string& name)
+{
+	return folder.empty() ? name : folder + '/' + name;
+}
+
+}
+
+#ifdef __linux__
+
+directory_watcher::directory_watcher()
+ : fd(inotify_init1(IN_CLOEXEC))
+{
+	if(fd < 0)
+		throw std::runtime_error(std::string("Unable to watch for changes: ") + std::strerror(errno));
+}
+
+directory_watcher::~directory_watcher()
+{
+	close(fd);
+}
+
+bool directory_watcher::watch_tree(std::size_t tree, const std::string& root, const std::string& folder, const source_filter* filter)
+{
+	const uint32_t mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE |
+		IN_ONLYDIR | IN_DONT_FOLLOW | IN_EXCL_UNLINK;
+
+	if(filter && !filter->descend(folder))
+		return true;
+
+	std::vector<std::string> folders;
+	walk_tree(folder.empty() ? root : root + folder + '/', [&](const std::string& rel_path, int, const std::vector<const char*>&, std::vector<std::string>& subdirs)
+	{
+		auto path = folder.empty() ? rel_path : (rel_path.empty() ? folder : folder + '/' + rel_path);
+		if(filter)
+			subdirs.erase(std::remove_if(subdirs.begin(), subdirs.end(), [&](const std::string& name){ return !filter->descend(join_path(path, name)); }), subdirs.end());
+		folders.push_back(std::move(path));
+	});
+
+	bool watched = true;
+	for(auto& path : folders)
+	{
+		int wd = inotify_add_watch(fd, (path.empty() ? root : root + path).c_str(), mask);
+		if(wd < 0)
+		{
+			watched = false;
+			continue;
+		}
+		// a directory moved inside the tree keeps its descriptor
+		watches[wd] = watch_t{tree, path};
+	}
+	return watched;
+}
+
+bool directory_watcher::wait(std::vector<change>& changes, bool& overflowed, int timeout_ms)
+{
+	pollfd pfd{fd, POLLIN, 0};
+	int ready;
+	do
+	{
+		ready = poll(&pfd, 1, timeout_ms);
+	} while(ready < 0 && errno == EINTR);
+	if(ready < 0)
+		throw std::runtime_error(std::string("Unable to wait for changes: ") + std::strerror(errno));
+	if(ready == 0)
+		return false;
+
+	alignas(inotify_event) char buffer[64 * 1024];
+	auto n = read(fd, buffer, sizeof(buffer));
+	if(n < 0)
+	{
+		if(errno == EINTR || errno == EAGAIN)
+			return true;
+		throw std::runtime_error(std::string("Unable to read changes: ") + std::strerror(errno));
+	}
+
+	for(decltype(n) pos = 0; pos < n;)
+	{
+		auto event = reinterpret_cast<const inotify_event*>(buffer + pos);
+		pos += sizeof(inotify_event) + event->len;
+
+		if(event->mask & IN_Q_OVERFLOW)
+		{
+			overflowed = true;
+			continue;
+		}
+		if(event->mask & IN_IGNORED)
+		{
+			watches.erase(event->wd);
+			continue;
+		}
+
+		auto watch = watches.find(event->wd);
+		if(watch == watches.end() || !event->len)
+			continue;
+
+		change c;
+		c.tree = watch->second.tree;
+		c.folder = watch->second.folder;
+		c.name = event->name;
+		c.directory = (event->mask & IN_ISDIR) != 0;
+		if(event->mask & (IN_CREATE | IN_MOVED_TO))
+			c.kind = change::added;
+		else if(event->mask & (IN_DELETE | IN_MOVED_FROM))
+			c.kind = change::removed;
+		else
+			c.kind = change::written;
+		changes.push_back(std::move(c));
+	}
+	return true;
+}
+
+#else
+
+directory_watcher::directory_watcher()
+ : fd(-1)
+{
+	throw std::runtime_error("Watching for changes is only supported on Linux");
+}
+
+directory_watcher::~directory_watcher()
+{
+}
+
+bool directory_watcher::watch_tree(std::size_t, const std::string&, const std::string&, const source_filter*)
+{
+	return false;
+}
+
+bool directory_watcher::wait(std::vector<change>&, bool&, int)
+{
+	return false;
+}
+
+#endif
+
+namespace
+{
+
+struct resident_project
+{
+	std::string path;
+	cmake::project_model model;
+	bool loaded = false;
+
+	// changes not yet applied to the model
+	bool dirty = false;
+	bool reload = false;
+	std::set<std::string> refresh;
+	std::set<std::string> rescan;
+};
+
+// Brings the model up to date with the pending changes and writes the
+// listfile. Returns the line to report.
+std::string regenerate(resident_project& project, const cmake::options& opts, unsigned int threads)
+{
+	std::string status;
+	try
+	{
+		// only the model stays resident; the descriptors are parsed again
+		// when they change, and as their source entries decide which
+		// folders hold sources the tree is walked again too
+		if(!project.loaded || project.reload)
+		{
+			cdt::project cdtproject(project.path);
+			cmake::result res;
+			project.model = cmake::extract(cdtproject, opts, res);
+			project.loaded = true;
+		}
+		else
+		{
+			for(auto& folder : project.rescan)
+				cmake::rescan_tree(project.model, folder, threads);
+			for(auto& folder : project.refresh)
+				cmake::refresh_folder(project.model, folder);
+		}
+
+		status = cmake::write_listfile(project.model) ? "regenerated" : "unchanged";
+	}
+	catch(const std::exception& ex)
+	{
+		// start from scratch on the next change
+		project.loaded = false;
+		status = std::string("Error: ") + ex.what();
+	}
+
+	project.dirty = false;
+	project.reload = false;
+	project.refresh.clear();
+	project.rescan.clear();
+	return project.path + ": " + status;
+}
+
+void regenerate_dirty(std::vector<resident_project>& projects, const cmake::options& opts, unsigned int jobs)
+{
+	std::vector<std::size_t> dirty;
+	for(std::size_t i = 0; i < projects.size(); ++i)
+	{
+		if(projects[i].dirty)
+			dirty.push_back(i);
+	}
+
+	std::vector<std::string> report(dirty.size());
+	if(jobs > 1 && dirty.size() > 1)
+	{
+		worker_pool pool(jobs);
+		for(std::size_t i = 0; i < dirty.size(); ++i)
+			pool.run([&, i]{ report[i] = regenerate(projects[dirty[i]], opts, 1); });
+		pool.wait();
+	}
+	else
+	{
+		for(std::size_t i = 0; i < dirty.size(); ++i)
+			report[i] = regenerate(projects[dirty[i]], opts, jobs);
+	}
+
+	for(auto& line : report)
+		std::cerr << line << "\n";
+	std::cerr << std::flush;
+}
+
+// Records what a change means for its project; false if nothing.
+bool apply_change(resident_project& project, const directory_watcher::change& c)
+{
+	if(!c.directory && c.folder.empty() && (c.name == ".project" || c.name == ".cproject"))
+	{
+		project.reload = true;
+		return true;
+	}
+	// rewritten sources do not change the listfile
+	if(c.kind == directory_watcher::change::written)
+		return false;
+
+	if(c.directory)
+	{
+		auto folder = join_path(c.folder, c.name);
+		if(project.loaded && !project.model.filter.descend(folder))
+			return false;
+		project.rescan.insert(folder);
+	}
+	else if(classify_source(c.name) != language::none)
+		project.refresh.insert(c.folder);
+	else
+		return false;
+	return true;
+}
+
+}
+
+void watch_projects(const std::vector<std::string>& project_paths, std::vector<cmake::project_model>& models, const cmake::options& options,
+		const watch_settings& settings)
+{
+	auto opts = options;
+	opts.write_files = true;
+	opts.record_directories = false;
+
+	directory_watcher watcher;
+
+	std::vector<resident_project> projects(project_paths.size());
+	for(std::size_t i = 0; i < projects.size(); ++i)
+	{
+		projects[i].path = project_paths[i];
+		if(i < models.size() && !models[i].path.empty())
+		{
+			projects[i].model = std::move(models[i]);
+			projects[i].loaded = true;
+		}
+		else
+		{
+			projects[i].dirty = true;
+		}
+	}
+	models.clear();
+	regenerate_dirty(projects, opts, settings.jobs);
+
+	// the filters of projects that failed to load leave nothing out
+	for(std::size_t i = 0; i < projects.size(); ++i)
+	{
+		auto filter = projects[i].loaded ? &projects[i].model.filter : nullptr;
+		if(!watcher.watch_tree(i, projects[i].path, {}, filter))
+			std::cerr << "Warning: unable to watch every folder of " << projects[i].path << "\n";
+	}
+	std::cerr << "Watching " << projects.size() << " projects for changes\n" << std::flush;
+
+	std::vector<directory_watcher::change> changes;
+	for(;;)
+	{
+		changes.clear();
+		bool overflowed = false;
+
+		// wait for a change, then until things have been quiet for a while
+		watcher.wait(changes, overflowed, -1);
+		while(watcher.wait(changes, overflowed, settings.quiet_ms))
+			;
+
+		for(auto& c : changes)
+		{
+			auto& project = projects[c.tree];
+			auto filter = project.loaded ? &project.model.filter : nullptr;
+			if(c.directory && c.kind == directory_watcher::change::added)
+				watcher.watch_tree(c.tree, project.path, join_path(c.folder, c.name), filter);
+			if(apply_change(project, c))
+				project.dirty = true;
+		}
+
+		// events were lost; every project has to be read again
+		if(overflowed)
+		{
+			std::cerr << "Warning: too many changes to follow, reloading every project\n";
+			for(auto& project : projects)
+			{
+				project.loaded = false;
+				project.dirty = true;
+			}
+		}
+
+		std::vector<std::size_t> reloaded;
+		for(std::size_t i = 0; i < projects.size(); ++i)
+		{
+			if(projects[i].dirty && (projects[i].reload || !projects[i].loaded))
+				reloaded.push_back(i);
+		}
+
+		regenerate_dirty(projects, opts, settings.jobs);
+
+		// the source entries may have changed; watch the folders they add
+		for(auto i : reloaded)
+		{
+			if(projects[i].loaded)
+				watcher.watch_tree(i, projects[i].path, {}, &projects[i].model.filter);
+		}
+	}
+}
@@ -0,0 +1,102 @@
+/*
+ * watch.h
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#ifndef WATCH_H_
+#define WATCH_H_
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+
+class source_filter;
+
+/*
+ * Reports entries created, removed, renamed or rewritten in watched
+ * directory trees. Directories created later are not watched until
+ * watch_tree is called for them. Linux only (inotify); elsewhere the
+ * constructor throws.
+ */
+class directory_watcher
+{
+public:
+	struct change
+	{
+		// as given to watch_tree
+		std::size_t tree;
+
+		// directory relative to the tree root ("" for the root) and the
+		// name of the entry in it that changed
+		std::string folder;
+		std::string name;
+
+		bool directory;
+
+		// created or moved in, removed or moved out, or written
+		enum kind_t
+		{
+			added,
+			removed,
+			written
+		} kind;
+	};
+
+	directory_watcher();
+	~directory_watcher();
+
+	directory_watcher(const directory_watcher&) = delete;
+	directory_watcher& operator=(const directory_watcher&) = delete;
+
+	// Watches root + folder and every directory below it; with a filter
+	// only the directories it descends into, as find_sources would.
+	// Returns false if some directory could not be watched.
+	bool watch_tree(std::size_t tree, const std::string& root, const std::string& folder = {}, const source_filter* filter = nullptr);
+
+	/*
+	 * Waits up to timeout_ms (-1 for no limit) for changes and appends
+	 * them. Returns false on timeout. If the kernel dropped events,
+	 * overflowed is set and the changes are incomplete.
+	 */
+	bool wait(std::vector<change>& changes, bool& overflowed, int timeout_ms);
+private:
+	int fd;
+
+	struct watch_t
+	{
+		std::size_t tree;
+		std::string folder;
+	};
+	std::unordered_map<int, watch_t> watches;
+};
+
+struct watch_settings
+{
+	// Threads for loading and regenerating projects.
+	unsigned int jobs = 1;
+
+	// Changes are collected until none arrived for this long.
+	int quiet_ms = 200;
+};
+
+namespace cmake
+{
+struct options;
+struct project_model;
+}
+
+/*
+ * Keeps the projects parsed and their sources listed in memory, and
+ * regenerates the CMakeLists.txt of a project whenever its descriptors
+ * change or a source file or folder is added, removed or renamed.
+ * models, indexed like projects, holds the models of projects already
+ * converted and is taken over; a project without one (an empty path)
+ * is converted first. Runs until the process is interrupted; throws if
+ * watching fails.
+ */
+void watch_projects(const std::vector<std::string>& projects, std::vector<cmake::project_model>& models, const cmake::options& opts,
+		const watch_settings& settings);
+
+#endif /* WATCH_H_ */
@@ -0,0 +1,139 @@
+/*
+ * workerpool.cpp
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#include "workerpool.h"
+
+namespace
+{
+thread_local const worker_pool* current_pool = nullptr;
+thread_local unsigned int current_index = 0;
+}
+
+worker_pool::worker_pool(unsigned int thread_count)
+ : queued(0), pending(0), stop(false)
+{
+	if(thread_count == 0)
+		thread_count = 1;
+
+	for(unsigned int i = 0; i < thread_count; ++i)
+		queues.emplace_back(new queue_t);
+
+	for(unsigned int i = 0; i < thread_count; ++i)
+		threads.emplace_back(&worker_pool::worker, this, i);
+}
+
+worker_pool::~worker_pool()
+{
+	wait();
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stop = true;
+	}
+	signal.notify_all();
+	for(auto& thread : threads)
+		thread.join();
+}
+
+void worker_pool::run(task_t task)
+{
+	{
+		auto& queue = current_pool == this ? *queues[current_index] : external;
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.tasks.push_back(std::move(task));
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		++queued;
+		++pending;
+	}
+	signal.notify_one();
+}
+
+void worker_pool::wait()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [this]{ return pending == 0; });
+}
+
+unsigned int worker_pool::size() const
+{
+	return threads.size();
+}
+
+unsigned int worker_pool::default_concurrency()
+{
+	auto n = std::thread::hardware_concurrency();
+	return n ? n : 1;
+}
+
+bool worker_pool::pop(unsigned int index, task_t& task)
+{
+	{
+		auto& own = *queues[index];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if(!own.tasks.empty())
+		{
+			task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+			return true;
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(external.mutex);
+		if(!external.tasks.empty())
+		{
+			task = std::move(external.tasks.front());
+			external.tasks.pop_front();
+			return true;
+		}
+	}
+
+	for(std::size_t i = 1; i < queues.size(); ++i)
+	{
+		auto& victim = *queues[(index + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if(!victim.tasks.empty())
+		{
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+void worker_pool::worker(unsigned int index)
+{
+	current_pool = this;
+	current_index = index;
+
+	for(;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			signal.wait(lock, [this]{ return stop || queued > 0; });
+			if(queued == 0)
+				return;
+
+			// reserve a task; it is guaranteed to be in one of the queues.
+			--queued;
+		}
+
+		task_t task;
+		while(!pop(index, task))
+			std::this_thread::yield();
+
+		task();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if(--pending == 0)
+				done.notify_all();
+		}
+	}
+}
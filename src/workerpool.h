@@ -0,0 +1,71 @@
+/*
+ * workerpool.h
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#ifndef WORKERPOOL_H_
+#define WORKERPOOL_H_
+#include <functional>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+
+/*
+ * Fixed size pool of threads, each with its own task deque.
+ * Tasks submitted from outside the pool go to a shared queue and
+ * start in submission order.
+ * Tasks submitted from inside a task go to the submitting worker's
+ * deque so recursive work stays local until someone steals it.
+ * A worker pops the newest task from its own deque, then the oldest
+ * external task, and otherwise steals the oldest task from another
+ * worker.
+ * Tasks must not throw.
+ */
+class worker_pool
+{
+public:
+	typedef std::function<void()> task_t;
+
+	explicit worker_pool(unsigned int threads);
+	~worker_pool();
+
+	worker_pool(const worker_pool&) = delete;
+	worker_pool& operator=(const worker_pool&) = delete;
+
+	void run(task_t task);
+
+	// Blocks until every submitted task has finished.
+	// Must not be called from inside a task of the same pool.
+	void wait();
+
+	unsigned int size() const;
+
+	static unsigned int default_concurrency();
+private:
+	struct queue_t
+	{
+		std::mutex mutex;
+		std::deque<task_t> tasks;
+	};
+
+	std::vector<std::unique_ptr<queue_t>> queues;
+	queue_t external;
+	std::vector<std::thread> threads;
+
+	std::mutex mutex;
+	std::condition_variable signal;
+	std::condition_variable done;
+	std::size_t queued;
+	std::size_t pending;
+	bool stop;
+
+	bool pop(unsigned int index, task_t& task);
+	void worker(unsigned int index);
+};
+
+#endif /* WORKERPOOL_H_ */
@@ -0,0 +1,250 @@
+/*
+ * workspace.cpp
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#include "workspace.h"
+#include "cdtproject.h"
+#include "workerpool.h"
+#include "treewalk.h"
+#include <map>
+#include <sstream>
+#include <exception>
+#include <algorithm>
+#include <mutex>
+#include <cstring>
+
+std::vector<std::string> find_projects(const std::string& root, const std::vector<std::string>& ignored, unsigned int threads)
+{
+	auto base = root.empty() || root.back() == '/' ? root : root + '/';
+	std::vector<std::string> skipped{".git", ".hg", ".svn"};
+	skipped.insert(skipped.end(), ignored.begin(), ignored.end());
+
+	std::vector<std::string> projects;
+	std::mutex projects_mutex;
+	walk_tree(base, [&](const std::string& rel_path, int, const std::vector<const char*>& files, std::vector<std::string>& subdirs)
+	{
+		bool project = false;
+		bool cproject = false;
+		for(auto file : files)
+		{
+			project = project || std::strcmp(file, ".project") == 0;
+			cproject = cproject || std::strcmp(file, ".cproject") == 0;
+		}
+
+		if(project && cproject)
+		{
+			subdirs.clear();
+			std::lock_guard<std::mutex> lock(projects_mutex);
+			projects.push_back(rel_path.empty() ? base : base + rel_path + '/');
+			return;
+		}
+
+		subdirs.erase(std::remove_if(subdirs.begin(), subdirs.end(), [&](const std::string& name)
+		{
+			return std::find(skipped.begin(), skipped.end(), name) != skipped.end();
+		}), subdirs.end());
+	}, threads);
+
+	std::sort(projects.begin(), projects.end());
+	return projects;
+}
+
+std::vector<workspace_project> load_workspace(const std::vector<std::string>& project_paths, unsigned int threads)
+{
+	std::vector<workspace_project> projects(project_paths.size());
+
+	auto load = [&](std::size_t i)
+	{
+		auto& project = projects[i];
+		project.path = project_paths[i];
+		try
+		{
+			auto description = cdt::read_project_description(project.path + ".project");
+			project.name = description.name;
+			project.references = description.references;
+		}
+		catch(const std::exception& ex)
+		{
+			project.error = ex.what();
+		}
+	};
+
+	if(threads > 1 && projects.size() > 1)
+	{
+		worker_pool pool(threads);
+		for(std::size_t i = 0; i < projects.size(); ++i)
+			pool.run([&, i]{ load(i); });
+		pool.wait();
+	}
+	else
+	{
+		for(std::size_t i = 0; i < projects.size(); ++i)
+			load(i);
+	}
+	return projects;
+}
+
+dependency_order order_by_dependencies(const std::vector<workspace_project>& projects)
+{
+	std::map<std::string, std::size_t> by_name;
+	for(std::size_t i = 0; i < projects.size(); ++i)
+	{
+		if(!projects[i].name.empty())
+			by_name.insert({projects[i].name, i});
+	}
+
+	// dependencies[i] are the projects i references, dependents the reverse.
+	std::vector<std::vector<std::size_t> > dependencies(projects.size());
+	std::vector<std::vector<std::size_t> > dependents(projects.size());
+	std::vector<std::size_t> pending(projects.size(), 0);
+	for(std::size_t i = 0; i < projects.size(); ++i)
+	{
+		for(auto& reference : projects[i].references)
+		{
+			auto it = by_name.find(reference);
+			if(it == by_name.end() || it->second == i)
+				continue;
+			dependencies[i].push_back(it->second);
+			dependents[it->second].push_back(i);
+			++pending[i];
+		}
+	}
+
+	dependency_order order;
+	std::vector<bool> placed(projects.size(), false);
+	std::vector<std::size_t> wave;
+	for(std::size_t i = 0; i < projects.size(); ++i)
+	{
+		if(!pending[i])
+			wave.push_back(i);
+	}
+
+	while(!wave.empty())
+	{
+		std::vector<bool> next(projects.size(), false);
+		for(auto i : wave)
+		{
+			placed[i] = true;
+			for(auto dependent : dependents[i])
+			{
+				if(--pending[dependent] == 0)
+					next[dependent] = true;
+			}
+		}
+		order.waves.push_back(std::move(wave));
+
+		wave.clear();
+		for(std::size_t i = 0; i < projects.size(); ++i)
+		{
+			if(next[i])
+				wave.push_back(i);
+		}
+	}
+
+	/*
+	 * Every project left has a dependency that is also left, so following
+	 * dependencies from any of them must come back to a project already
+	 * on the path. Walks that run into an earlier walk are only behind a
+	 * cycle that has been reported.
+	 */
+	std::vector<int> walked(projects.size(), 0);
+	int walk = 0;
+	for(std::size_t start = 0; start < projects.size(); ++start)
+	{
+		if(placed[start] || walked[start])
+			continue;
+
+		++walk;
+		std::vector<std::size_t> path;
+		auto i = start;
+		while(!walked[i])
+		{
+			walked[i] = walk;
+			path.push_back(i);
+			for(auto dependency : dependencies[i])
+			{
+				if(!placed[dependency])
+				{
+					i = dependency;
+					break;
+				}
+			}
+		}
+
+		if(walked[i] == walk)
+		{
+			std::vector<std::size_t> cycle;
+			for(auto it = path.begin(); it != path.end(); ++it)
+			{
+				if(*it == i)
+				{
+					cycle.assign(it, path.end());
+					break;
+				}
+			}
+			order.cycles.push_back(cycle);
+		}
+	}
+
+	for(std::size_t i = 0; i < projects.size(); ++i)
+	{
+		if(!placed[i])
+			order.unordered.push_back(i);
+	}
+	return order;
+}
+
+std::string common_parent(const std::vector<std::string>& project_paths)
+{
+	if(project_paths.empty())
+		return {};
+
+	// the parent of the first project, then shortened to fit the others
+	auto parent = project_paths.front();
+	while(!parent.empty() && parent.back() == '/')
+		parent.pop_back();
+	auto slash = parent.rfind('/');
+	parent = slash == std::string::npos ? std::string() : parent.substr(0, slash + 1);
+
+	for(auto& path : project_paths)
+	{
+		while(!parent.empty() && path.compare(0, parent.size(), parent) != 0)
+		{
+			parent.pop_back();
+			slash = parent.rfind('/');
+			parent = slash == std::string::npos ? std::string() : parent.substr(0, slash + 1);
+		}
+	}
+	return parent;
+}
+
+std::string top_level_listfile(const std::string& parent, const std::vector<std::string>& project_paths, const std::string& definitions,
+		const std::string& minimum_version)
+{
+	auto name = parent;
+	while(!name.empty() && name.back() == '/')
+		name.pop_back();
+	auto slash = name.rfind('/');
+	if(slash != std::string::npos)
+		name = name.substr(slash + 1);
+	if(name.empty() || name == "." || name == "..")
+		name = "workspace";
+
+	std::ostringstream listfile;
+	listfile << "cmake_minimum_required (VERSION " << minimum_version << ")\n";
+	listfile << "project (" << name << ")\n";
+	listfile << "\n";
+	listfile << definitions;
+	for(auto& path : project_paths)
+	{
+		auto subdirectory = path.substr(parent.size());
+		while(!subdirectory.empty() && subdirectory.back() == '/')
+			subdirectory.pop_back();
+		listfile << "add_subdirectory(" << subdirectory << ")\n";
+	}
+	listfile << '\n';
+	return listfile.str();
+}
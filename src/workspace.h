@@ -0,0 +1,62 @@
+/*
+ * workspace.h
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#ifndef WORKSPACE_H_
+#define WORKSPACE_H_
+#include <string>
+#include <vector>
+#include <cstddef>
+
+struct workspace_project
+{
+	std::string path;
+	std::string name;
+
+	// names of the projects this one references in its .project
+	std::vector<std::string> references;
+
+	// set when the .project could not be read
+	std::string error;
+};
+
+/*
+ * Walks the tree below root, spread over threads, for folders holding
+ * both a .project and a .cproject. Folders below a project are not
+ * searched, nor directories named .git, .hg, .svn or in ignored.
+ * Returns the project folders with a trailing '/', sorted.
+ */
+std::vector<std::string> find_projects(const std::string& root, const std::vector<std::string>& ignored = {}, unsigned int threads = 1);
+
+// Reads the .project of each project folder, spread over threads.
+std::vector<workspace_project> load_workspace(const std::vector<std::string>& project_paths, unsigned int threads = 1);
+
+struct dependency_order
+{
+	// Indices into the project list. Every project in a wave depends
+	// only on projects of earlier waves; within a wave projects keep
+	// their original order.
+	std::vector<std::vector<std::size_t> > waves;
+
+	// Each cycle is a chain of indices whose last element references
+	// the first. Projects on or behind a cycle are not in any wave.
+	std::vector<std::vector<std::size_t> > cycles;
+	std::vector<std::size_t> unordered;
+};
+
+// References to projects outside the list are ignored.
+dependency_order order_by_dependencies(const std::vector<workspace_project>& projects);
+
+// Longest directory that contains every project folder, with a trailing
+// '/', or empty when the folders are relative and share no prefix.
+std::string common_parent(const std::vector<std::string>& project_paths);
+
+// Top level listfile adding each project folder below parent in order,
+// after the definitions (of targets shared by the projects).
+std::string top_level_listfile(const std::string& parent, const std::vector<std::string>& project_paths, const std::string& definitions = {},
+		const std::string& minimum_version = "2.8");
+
+#endif /* WORKSPACE_H_ */
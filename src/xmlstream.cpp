@@ -0,0 +1,469 @@
+/*
+ * xmlstream.cpp
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#include "xmlstream.h"
+#include <cstring>
+#include <cstdlib>
+
+namespace
+{
+
+bool is_space(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool starts_with(const char* pos, const char* end, const char* prefix)
+{
+	auto len = std::strlen(prefix);
+	return static_cast<std::size_t>(end - pos) >= len && std::memcmp(pos, prefix, len) == 0;
+}
+
+const char* find(const char* pos, const char* end, const char* what)
+{
+	auto len = std::strlen(what);
+	for(; static_cast<std::size_t>(end - pos) >= len; ++pos)
+	{
+		if(*pos == *what && std::memcmp(pos, what, len) == 0)
+			return pos;
+	}
+	return nullptr;
+}
+
+bool same(const text_view& l, const text_view& r)
+{
+	return l.size == r.size && std::memcmp(l.data, r.data, l.size) == 0;
+}
+
+void append_utf8(std::string& s, unsigned long cp)
+{
+	if(cp < 0x80)
+	{
+		s += static_cast<char>(cp);
+	}
+	else if(cp < 0x800)
+	{
+		s += static_cast<char>(0xC0 | (cp >> 6));
+		s += static_cast<char>(0x80 | (cp & 0x3F));
+	}
+	else if(cp < 0x10000)
+	{
+		s += static_cast<char>(0xE0 | (cp >> 12));
+		s += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+		s += static_cast<char>(0x80 | (cp & 0x3F));
+	}
+	else
+	{
+		s += static_cast<char>(0xF0 | (cp >> 18));
+		s += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+		s += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+		s += static_cast<char>(0x80 | (cp & 0x3F));
+	}
+}
+
+}
+
+std::string text_view::str() const
+{
+	return {data, size};
+}
+
+bool operator==(const text_view& view, const char* s)
+{
+	return std::strlen(s) == view.size && std::memcmp(view.data, s, view.size) == 0;
+}
+bool operator==(const text_view& view, const std::string& s)
+{
+	return s.size() == view.size && std::memcmp(view.data, s.data(), view.size) == 0;
+}
+bool operator!=(const text_view& view, const char* s)
+{
+	return !(view == s);
+}
+bool operator!=(const text_view& view, const std::string& s)
+{
+	return !(view == s);
+}
+
+xml_error::xml_error(const std::string& what)
+ : std::runtime_error(what)
+{
+}
+
+xml_reader::xml_reader(const char* begin, const char* end)
+ : pos(begin), end(end), current{begin, 0}, attribute_count(0), empty_pending(false)
+{
+	// UTF-8 byte order mark
+	if(starts_with(pos, end, "\xEF\xBB\xBF"))
+		pos += 3;
+}
+
+xml_reader::event_t xml_reader::next()
+{
+	if(empty_pending)
+	{
+		empty_pending = false;
+		open.pop_back();
+		return end_element;
+	}
+
+	for(;;)
+	{
+		pos = static_cast<const char*>(std::memchr(pos, '<', end - pos));
+		if(!pos)
+		{
+			pos = end;
+			if(!open.empty())
+				fail("Unexpected end of document in <" + open.back().str() + ">");
+			return end_document;
+		}
+
+		if(skip_markup())
+			continue;
+
+		if(starts_with(pos, end, "</"))
+		{
+			pos += 2;
+			current = read_name();
+			skip_space();
+			if(pos == end || *pos != '>')
+				fail("Malformed end tag </" + current.str() + ">");
+			++pos;
+
+			if(open.empty() || !same(open.back(), current))
+				fail("Mismatched end tag </" + current.str() + ">");
+			open.pop_back();
+			return end_element;
+		}
+
+		++pos;
+		current = read_name();
+		attribute_count = 0;
+		for(;;)
+		{
+			skip_space();
+			if(pos == end)
+				fail("Unterminated tag <" + current.str() + ">");
+
+			if(*pos == '/')
+			{
+				if(!starts_with(pos, end, "/>"))
+					fail("Malformed tag <" + current.str() + ">");
+				pos += 2;
+				empty_pending = true;
+				break;
+			}
+			if(*pos == '>')
+			{
+				++pos;
+				break;
+			}
+
+			if(attributes.size() == attribute_count)
+				attributes.emplace_back();
+			auto& attribute = attributes[attribute_count++];
+
+			attribute.first = read_name();
+			skip_space();
+			if(pos == end || *pos != '=')
+				fail("Missing value for attribute " + attribute.first.str());
+			++pos;
+			skip_space();
+			if(pos == end || (*pos != '"' && *pos != '\''))
+				fail("Unquoted value for attribute " + attribute.first.str());
+
+			auto quote = *pos++;
+			auto close = static_cast<const char*>(std::memchr(pos, quote, end - pos));
+			if(!close)
+				fail("Unterminated attribute value");
+			attribute.second = {pos, static_cast<std::size_t>(close - pos)};
+			pos = close + 1;
+		}
+		open.push_back(current);
+		return start_element;
+	}
+}
+
+text_view xml_reader::name() const
+{
+	return current;
+}
+
+const text_view* xml_reader::find_attribute(const char* name) const
+{
+	for(std::size_t i = 0; i < attribute_count; ++i)
+	{
+		if(attributes[i].first == name)
+			return &attributes[i].second;
+	}
+	return nullptr;
+}
+
+bool xml_reader::has_attribute(const char* name) const
+{
+	return find_attribute(name) != nullptr;
+}
+
+bool xml_reader::attribute_is(const char* name, const char* value) const
+{
+	auto raw = find_attribute(name);
+	if(!raw)
+		return false;
+	if(!std::memchr(raw->data, '&', raw->size))
+		return *raw == value;
+
+	std::string decoded;
+	decode(*raw, decoded);
+	return decoded == value;
+}
+
+bool xml_reader::query_attribute(const char* name, std::string& value) const
+{
+	auto raw = find_attribute(name);
+	if(!raw)
+		return false;
+	decode(*raw, value);
+	return true;
+}
+
+bool xml_reader::raw_attribute(const char* name, text_view& value) const
+{
+	auto raw = find_attribute(name);
+	if(!raw)
+		return false;
+	value = *raw;
+	return true;
+}
+
+bool xml_reader::read_text(std::string& text)
+{
+	text.clear();
+	if(empty_pending)
+	{
+		empty_pending = false;
+		open.pop_back();
+		return false;
+	}
+
+	std::string raw;
+	std::string chunk;
+	for(;;)
+	{
+		auto lt = static_cast<const char*>(std::memchr(pos, '<', end - pos));
+		if(!lt)
+			fail("Unexpected end of document in <" + open.back().str() + ">");
+
+		decode({pos, static_cast<std::size_t>(lt - pos)}, chunk);
+		raw += chunk;
+		pos = lt;
+
+		if(starts_with(pos, end, "<![CDATA["))
+		{
+			auto close = find(pos, end, "]]>");
+			if(!close)
+				fail("Unterminated markup");
+			raw.append(pos + 9, close);
+			pos = close + 3;
+			continue;
+		}
+		if(skip_markup())
+			continue;
+
+		// a child element is skipped; otherwise this is our end tag
+		if(next() == start_element)
+			skip();
+		else
+			break;
+	}
+
+	bool space = false;
+	for(auto c : raw)
+	{
+		if(is_space(c))
+		{
+			space = !text.empty();
+			continue;
+		}
+		if(space)
+			text += ' ';
+		space = false;
+		text += c;
+	}
+	return !text.empty();
+}
+
+void xml_reader::skip()
+{
+	if(empty_pending)
+	{
+		empty_pending = false;
+		open.pop_back();
+		return;
+	}
+
+	// Scan for tag boundaries only; nothing is decoded or stored.
+	std::size_t level = 1;
+	while(level)
+	{
+		pos = static_cast<const char*>(std::memchr(pos, '<', end - pos));
+		if(!pos)
+			fail("Unexpected end of document in <" + open.back().str() + ">");
+
+		if(skip_markup())
+			continue;
+
+		bool closing = pos + 1 != end && pos[1] == '/';
+		char quote = 0;
+		for(++pos; pos != end; ++pos)
+		{
+			if(quote)
+			{
+				if(*pos == quote)
+					quote = 0;
+			}
+			else if(*pos == '"' || *pos == '\'')
+			{
+				quote = *pos;
+			}
+			else if(*pos == '>')
+			{
+				break;
+			}
+		}
+		if(pos == end)
+			fail("Unterminated tag in <" + open.back().str() + ">");
+
+		if(closing)
+			--level;
+		else if(pos[-1] != '/')
+			++level;
+		++pos;
+	}
+	current = open.back();
+	open.pop_back();
+}
+
+void xml_reader::skip_to(std::size_t level)
+{
+	while(depth() > level)
+	{
+		switch(next())
+		{
+			case start_element:
+				skip();
+				break;
+			case end_element:
+				break;
+			case end_document:
+				return;
+		}
+	}
+}
+
+std::size_t xml_reader::depth() const
+{
+	return open.size();
+}
+
+bool xml_reader::skip_markup()
+{
+	const char* close = nullptr;
+	if(starts_with(pos, end, "<?"))
+	{
+		close = find(pos, end, "?>");
+	}
+	else if(starts_with(pos, end, "<!--"))
+	{
+		close = find(pos, end, "-->");
+	}
+	else if(starts_with(pos, end, "<![CDATA["))
+	{
+		close = find(pos, end, "]]>");
+	}
+	else if(starts_with(pos, end, "<!"))
+	{
+		close = static_cast<const char*>(std::memchr(pos, '>', end - pos));
+		if(close && std::memchr(pos, '[', close - pos))
+			fail("Internal DTD subsets are not supported");
+	}
+	else
+	{
+		return false;
+	}
+
+	if(!close)
+		fail("Unterminated markup");
+	pos = static_cast<const char*>(std::memchr(close, '>', end - close)) + 1;
+	return true;
+}
+
+text_view xml_reader::read_name()
+{
+	auto begin = pos;
+	while(pos != end && !is_space(*pos) && *pos != '/' && *pos != '>' && *pos != '=')
+		++pos;
+	if(pos == begin)
+		fail("Expected a name");
+	return {begin, static_cast<std::size_t>(pos - begin)};
+}
+
+void xml_reader::decode(const text_view& raw, std::string& value) const
+{
+	auto p = raw.data;
+	auto raw_end = raw.data + raw.size;
+
+	auto amp = static_cast<const char*>(std::memchr(p, '&', raw.size));
+	if(!amp)
+	{
+		value.assign(p, raw.size);
+		return;
+	}
+
+	value.assign(p, amp);
+	for(p = amp; p != raw_end; ++p)
+	{
+		if(*p != '&')
+		{
+			value += *p;
+			continue;
+		}
+
+		auto semi = static_cast<const char*>(std::memchr(p, ';', raw_end - p));
+		if(!semi)
+			fail("Unterminated entity reference");
+
+		std::string entity(p + 1, semi);
+		if(entity == "amp")
+			value += '&';
+		else if(entity == "lt")
+			value += '<';
+		else if(entity == "gt")
+			value += '>';
+		else if(entity == "quot")
+			value += '"';
+		else if(entity == "apos")
+			value += '\'';
+		else if(entity.size() > 2 && entity[0] == '#' && entity[1] == 'x')
+			append_utf8(value, std::strtoul(entity.c_str() + 2, nullptr, 16));
+		else if(entity.size() > 1 && entity[0] == '#')
+			append_utf8(value, std::strtoul(entity.c_str() + 1, nullptr, 10));
+		else
+			fail("Unknown entity &" + entity + ";");
+		p = semi;
+	}
+}
+
+void xml_reader::skip_space()
+{
+	while(pos != end && is_space(*pos))
+		++pos;
+}
+
+void xml_reader::fail(const std::string& what) const
+{
+	throw xml_error(what);
+}
@@ -0,0 +1,107 @@
+/*
+ * xmlstream.h
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#ifndef XMLSTREAM_H_
+#define XMLSTREAM_H_
+#include <string>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+
+/*
+ * Raised for input the reader cannot handle; callers are expected to
+ * fall back to a full DOM parse.
+ */
+struct xml_error : std::runtime_error
+{
+	explicit xml_error(const std::string& what);
+};
+
+// Characters of the document being read; valid while the document is.
+struct text_view
+{
+	const char* data;
+	std::size_t size;
+
+	std::string str() const;
+};
+
+bool operator==(const text_view& view, const char* s);
+bool operator==(const text_view& view, const std::string& s);
+bool operator!=(const text_view& view, const char* s);
+bool operator!=(const text_view& view, const std::string& s);
+
+/*
+ * Forward only pull reader over an in-memory document.
+ * Only elements and their attributes are reported; text, comments and
+ * processing instructions are passed over. Subtrees that are not
+ * interesting can be skipped without decoding them.
+ *
+ * <a x="1"><b/></a> reads as start(a) start(b) end(b) end(a).
+ *
+ * Names and attribute values are views into the document; values are
+ * only copied, and entities only decoded, when they are queried.
+ */
+class xml_reader
+{
+public:
+	enum event_t
+	{
+		start_element,
+		end_element,
+		end_document
+	};
+
+	xml_reader(const char* begin, const char* end);
+
+	event_t next();
+
+	// name of the current element (valid after start_element and end_element)
+	text_view name() const;
+
+	// attributes of the current element (valid after start_element)
+	bool has_attribute(const char* name) const;
+	bool attribute_is(const char* name, const char* value) const;
+	bool query_attribute(const char* name, std::string& value) const;
+
+	// Undecoded attribute value as it appears in the document.
+	bool raw_attribute(const char* name, text_view& value) const;
+
+	// Consumes the element just started and returns its character data
+	// with surrounding whitespace removed and inner runs of whitespace
+	// collapsed to one space. Child elements are skipped.
+	// Returns false if there is no text.
+	bool read_text(std::string& text);
+
+	// Consumes everything up to and including the end of the element
+	// just started.
+	void skip();
+
+	// Consumes elements until depth() == level.
+	void skip_to(std::size_t level);
+
+	// Number of open elements.
+	std::size_t depth() const;
+private:
+	const char* pos;
+	const char* end;
+
+	std::vector<text_view> open;
+	text_view current;
+	std::vector<std::pair<text_view, text_view>> attributes;
+	std::size_t attribute_count;
+	bool empty_pending;
+
+	const text_view* find_attribute(const char* name) const;
+	bool skip_markup();
+	text_view read_name();
+	void decode(const text_view& raw, std::string& value) const;
+	void skip_space();
+	[[noreturn]] void fail(const std::string& what) const;
+};
+
+#endif /* XMLSTREAM_H_ */
@@ -0,0 +1,14 @@
+# Converts PROJECT_DIR with CDT2CMAKE and ARGS and fails unless the
+# listfile written to stdout equals EXPECTED and nothing was reported
+# on stderr.
+EXECUTE_PROCESS(COMMAND ${CDT2CMAKE} ${ARGS} ${PROJECT_DIR}
+	OUTPUT_VARIABLE output ERROR_VARIABLE errors RESULT_VARIABLE status)
+
+IF(NOT status EQUAL 0 OR NOT errors STREQUAL "")
+	MESSAGE(FATAL_ERROR "cdt2cmake ${ARGS} ${PROJECT_DIR} exited with ${status}:\n${errors}")
+ENDIF()
+
+FILE(READ ${EXPECTED} expected)
+IF(NOT output STREQUAL expected)
+	MESSAGE(FATAL_ERROR "Listfile differs from ${EXPECTED}:\n${output}")
+ENDIF()
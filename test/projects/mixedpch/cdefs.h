@@ -0,0 +1 @@
+#define C_ONLY 1
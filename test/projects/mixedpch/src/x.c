@@ -0,0 +1,4 @@
+#ifndef C_ONLY
+#error no C header
+#endif
+int c_func(void){return C_ONLY;}
@@ -0,0 +1,84 @@
+/*
+ * test_cdtoptions.cpp
+ *
+ *  Created on: 17/10/2026
+ *      Author: nicholas
+ */
+
+#include <string>
+#include <iostream>
+#include <cstring>
+
+#include "cdtoptions.h"
+
+/*
+ * Checks that tool and option superClass ids, as written by CDT, are
+ * classified by the keyword tables. Prints each mismatch and exits
+ * non zero if there was one.
+ */
+
+namespace
+{
+
+int failures = 0;
+
+template <typename Kind>
+void check(const std::string& id, Kind kind, Kind expected)
+{
+	if(kind == expected)
+		return;
+	std::cerr << id << ": classified as " << static_cast<int>(kind) << ", expected " << static_cast<int>(expected) << "\n";
+	++failures;
+}
+
+void check_tool(const std::string& id, cdt::tool_kind expected)
+{
+	check(id, cdt::classify_tool(id), expected);
+}
+
+void check_option(const std::string& id, cdt::option_kind expected)
+{
+	check(id, cdt::classify_option(id), expected);
+}
+
+}
+
+int main()
+{
+	using cdt::tool_kind;
+	using cdt::option_kind;
+
+	check_tool("cdt.managedbuild.tool.gnu.cpp.compiler.exe.debug", tool_kind::cpp_compiler);
+	check_tool("cdt.managedbuild.tool.gnu.c.compiler.so.release", tool_kind::c_compiler);
+	check_tool("cdt.managedbuild.tool.gnu.cpp.linker.exe.release", tool_kind::cpp_linker);
+	check_tool("cdt.managedbuild.tool.gnu.c.linker.so.debug", tool_kind::c_linker);
+	check_tool("cdt.managedbuild.tool.gnu.archiver.base", tool_kind::unknown);
+
+	// an id naming both compilers is the c++ one, as cpp.compiler is listed first
+	check_tool("cdt.managedbuild.tool.gnu.c.compiler.base.cpp.compiler", tool_kind::cpp_compiler);
+	check_tool("cdt.managedbuild.tool.gnu.cpp.compiler.base.c.compiler", tool_kind::cpp_compiler);
+
+	check_option("gnu.cpp.compiler.option.include.paths", option_kind::include_paths);
+	check_option("gnu.c.compiler.option.preprocessor.def.symbols", option_kind::defines);
+	check_option("gnu.cpp.compiler.option.preprocessor.def", option_kind::defines);
+	check_option("gnu.cpp.compiler.option.other.other", option_kind::other_flags);
+	check_option("gnu.cpp.compiler.exe.debug.option.optimization.level", option_kind::optimization_level);
+	check_option("gnu.c.compiler.so.release.option.optimization.level", option_kind::optimization_level);
+	check_option("gnu.cpp.compiler.exe.debug.option.debugging.level", option_kind::debugging_level);
+	check_option("gnu.c.compiler.so.debug.option.debugging.level", option_kind::debugging_level);
+	check_option("gnu.cpp.compiler.option.other.pic", option_kind::pic);
+	check_option("gnu.c.compiler.option.misc.pic", option_kind::pic);
+	check_option("gnu.cpp.compiler.option.dialect.std", option_kind::language_standard);
+	check_option("gnu.cpp.link.option.libs", option_kind::libs);
+	check_option("gnu.c.link.option.paths", option_kind::lib_paths);
+	check_option("gnu.cpp.link.option.flags", option_kind::link_flags);
+	check_option("gnu.cpp.compiler.option.warnings.allwarn", option_kind::unknown);
+
+	// ids are classified in place, so nothing past size may be read
+	const char* document = "gnu.cpp.compiler.option.other.pic\" value=\"true\"";
+	auto size = std::strlen("gnu.cpp.compiler.option.other");
+	check("gnu.cpp.compiler.option.other", cdt::classify_option(document, size), option_kind::unknown);
+	check("gnu.cpp.compiler.option.other.pic", cdt::classify_option(document, std::strlen("gnu.cpp.compiler.option.other.pic")), option_kind::pic);
+
+	return failures ? 1 : 0;
+}